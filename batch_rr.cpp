@@ -0,0 +1,661 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sstream>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "policies.h"
+#include "trace.h"
+
+namespace {
+
+// Round robin over many independent traces at once. Each lane of the batch
+// is one simulation with the exact tick semantics of rr.cpp, laid out as
+// structure of arrays so one kernel advances a whole vector of lanes in
+// lockstep, with divergent events (arrival, completion, IO request, quantum
+// expiry, IO completion, dispatch) handled under lane masks. A finished
+// lane is refilled with the next trace. Build with -mavx2 or -mavx512f (or
+// -march=native) to get the vector kernels.
+
+const int32_t noProc = -1;
+const int32_t noArrival = INT32_MAX;
+
+typedef struct Process {
+  std::string procName;
+  size_t arrivalTime = SIZE_MAX;
+  size_t burstTimeCPU = SIZE_MAX;
+  size_t burstTimeIO = SIZE_MAX;
+  size_t burstTimeRate = SIZE_MAX;  // IO burst after every n CPU bursts
+
+  Process() {}
+  Process(std::string&& name,
+          size_t at,
+          size_t btCPU,
+          size_t btIO,
+          size_t btr) {
+    procName = std::move(name);
+    arrivalTime = at;
+    burstTimeCPU = btCPU;
+    burstTimeIO = btIO;
+    burstTimeRate = btr;
+  }
+} Process;
+typedef std::vector<Process> Processes;
+
+// One simulation's input in arrival order, plus its results. A trace with a
+// log gets rr.cpp's tick log, which only the one-lane-at-a-time path writes.
+typedef struct Trace {
+  std::string traceName;
+  std::ostream* log = nullptr;
+  std::vector<std::string> procName;
+  std::vector<int32_t> arrivalTime, burstTimeCPU, burstTimeIO, burstTimeRate;
+  std::vector<int32_t> startTime, completionTime;
+
+  Trace() {}
+  Trace(std::string&& name, Processes procs) {
+    traceName = std::move(name);
+    std::stable_sort(procs.begin(), procs.end(),
+                     [](const Process& a, const Process& b) {
+                       return a.arrivalTime < b.arrivalTime;
+                     });
+    for (auto& proc : procs) {
+      procName.push_back(proc.procName);
+      arrivalTime.push_back(proc.arrivalTime);
+      burstTimeCPU.push_back(proc.burstTimeCPU);
+      burstTimeIO.push_back(proc.burstTimeIO);
+      burstTimeRate.push_back(proc.burstTimeRate);
+    }
+    startTime.assign(procs.size(), INT32_MAX);
+    completionTime.assign(procs.size(), 0);
+  }
+  size_t size() const { return arrivalTime.size(); }
+  int32_t waitingTime(size_t i) const {
+    return completionTime[i] - arrivalTime[i] - burstTimeCPU[i];
+  }
+  double avgWaitingTime() const {
+    double sum = 0;
+    for (size_t i = 0; i < size(); i++) {
+      sum += waitingTime(i);
+    }
+    return sum / size();
+  }
+} Trace;
+typedef std::vector<Trace> Traces;
+
+// Thin layer over the vector ISA so the kernel is written once. V holds one
+// int32 per lane and M is a lane mask; the scalar build is a width-1 vector.
+namespace simd {
+#if defined(__AVX512F__)
+const size_t width = 16;
+typedef __m512i V;
+typedef __mmask16 M;
+inline V set1(int32_t x) { return _mm512_set1_epi32(x); }
+inline V load(const int32_t* p) { return _mm512_loadu_si512(p); }
+inline void store(int32_t* p, V v) { _mm512_storeu_si512(p, v); }
+inline V add(V a, V b) { return _mm512_add_epi32(a, b); }
+inline V sub(V a, V b) { return _mm512_sub_epi32(a, b); }
+inline V min(V a, V b) { return _mm512_min_epi32(a, b); }
+inline V band(V a, V b) { return _mm512_and_si512(a, b); }
+inline M gt(V a, V b) { return _mm512_cmpgt_epi32_mask(a, b); }
+inline M ge(V a, V b) { return _mm512_cmpge_epi32_mask(a, b); }
+inline M eq(V a, V b) { return _mm512_cmpeq_epi32_mask(a, b); }
+inline M both(M a, M b) { return a & b; }
+inline M either(M a, M b) { return a | b; }
+inline M but(M a, M b) { return a & ~b; }
+inline uint32_t bits(M m) { return m; }
+inline V select(M m, V a, V b) { return _mm512_mask_blend_epi32(m, b, a); }
+inline V gather(M m, V src, const int32_t* base, V idx) {
+  return _mm512_mask_i32gather_epi32(src, m, idx, base, 4);
+}
+inline void scatter(M m, int32_t* base, V idx, V v) {
+  _mm512_mask_i32scatter_epi32(base, m, idx, v, 4);
+}
+#elif defined(__AVX2__)
+const size_t width = 8;
+typedef __m256i V;
+typedef __m256i M;
+inline V set1(int32_t x) { return _mm256_set1_epi32(x); }
+inline V load(const int32_t* p) { return _mm256_loadu_si256((const V*)p); }
+inline void store(int32_t* p, V v) { _mm256_storeu_si256((V*)p, v); }
+inline V add(V a, V b) { return _mm256_add_epi32(a, b); }
+inline V sub(V a, V b) { return _mm256_sub_epi32(a, b); }
+inline V min(V a, V b) { return _mm256_min_epi32(a, b); }
+inline V band(V a, V b) { return _mm256_and_si256(a, b); }
+inline M gt(V a, V b) { return _mm256_cmpgt_epi32(a, b); }
+inline M ge(V a, V b) {
+  return _mm256_xor_si256(_mm256_cmpgt_epi32(b, a), _mm256_set1_epi32(-1));
+}
+inline M eq(V a, V b) { return _mm256_cmpeq_epi32(a, b); }
+inline M both(M a, M b) { return _mm256_and_si256(a, b); }
+inline M either(M a, M b) { return _mm256_or_si256(a, b); }
+inline M but(M a, M b) { return _mm256_andnot_si256(b, a); }
+inline uint32_t bits(M m) { return _mm256_movemask_ps(_mm256_castsi256_ps(m)); }
+inline V select(M m, V a, V b) { return _mm256_blendv_epi8(b, a, m); }
+inline V gather(M m, V src, const int32_t* base, V idx) {
+  return _mm256_mask_i32gather_epi32(src, base, idx, m, 4);
+}
+// AVX2 has no scatter; spill and store the selected lanes one by one.
+inline void scatter(M m, int32_t* base, V idx, V v) {
+  alignas(32) int32_t at[8], val[8];
+  store(at, idx);
+  store(val, v);
+  for (uint32_t lanes = bits(m); lanes; lanes &= lanes - 1) {
+    base[at[__builtin_ctz(lanes)]] = val[__builtin_ctz(lanes)];
+  }
+}
+#else
+const size_t width = 1;
+typedef int32_t V;
+typedef bool M;
+inline V set1(int32_t x) { return x; }
+inline V load(const int32_t* p) { return *p; }
+inline void store(int32_t* p, V v) { *p = v; }
+inline V add(V a, V b) { return a + b; }
+inline V sub(V a, V b) { return a - b; }
+inline V min(V a, V b) { return std::min(a, b); }
+inline V band(V a, V b) { return a & b; }
+inline M gt(V a, V b) { return a > b; }
+inline M ge(V a, V b) { return a >= b; }
+inline M eq(V a, V b) { return a == b; }
+inline M both(M a, M b) { return a && b; }
+inline M either(M a, M b) { return a || b; }
+inline M but(M a, M b) { return a && !b; }
+inline uint32_t bits(M m) { return m; }
+inline V select(M m, V a, V b) { return m ? a : b; }
+inline V gather(M m, V src, const int32_t* base, V idx) {
+  return m ? base[idx] : src;
+}
+inline void scatter(M m, int32_t* base, V idx, V v) {
+  if (m) {
+    base[idx] = v;
+  }
+}
+#endif
+}  // namespace simd
+
+class BatchDevice {
+ public:
+  BatchDevice(size_t lanes, bool batched, int32_t timeQuantum) {
+    this->batched = batched;
+    this->timeQuantum = timeQuantum;
+    laneCount = batched ? (lanes + simd::width - 1) / simd::width * simd::width
+                        : lanes;
+  }
+
+  void run(Traces& traces) {
+    this->traces = &traces;
+    nextTrace = 0;
+    activeLanes = 0;
+    stride = 1;
+    for (auto& trace : traces) {
+      while (stride < trace.size()) {
+        stride *= 2;
+      }
+    }
+    for (auto field : {&tick, &alive, &procCount, &arrived, &nextArrival,
+                       &runSlot, &runRemain, &runLastIO, &runRate, &q,
+                       &ioSlot, &countIOBurst, &burstTimeIO, &readyHead,
+                       &readyLen, &ioHead, &ioQLen, &laneOffset}) {
+      field->assign(laneCount, 0);
+    }
+    for (auto table : {&arrivalTab, &burstRemainTab, &lastIOTab, &rateTab,
+                       &burstIOTab, &startTab, &completionTab, &readyRing,
+                       &ioRing}) {
+      table->assign(laneCount * stride, 0);
+    }
+    traceOf.assign(laneCount, nullptr);
+    for (size_t i = 0; i < laneCount; i++) {
+      laneOffset[i] = i * stride;
+      refill(i);
+    }
+    while (activeLanes) {
+      if (batched) {
+        for (size_t base = 0; base < laneCount; base += simd::width) {
+          advanceChunk(base);
+        }
+      } else {
+        for (size_t i = 0; i < laneCount; i++) {
+          if (alive[i]) {
+            processor(i);
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  bool batched = true;
+  int32_t timeQuantum = 5;
+  size_t laneCount = 0;
+  size_t activeLanes = 0;
+  size_t stride = 1;
+  Traces* traces = nullptr;
+  size_t nextTrace = 0;
+  std::vector<Trace*> traceOf;
+
+  // Structure of arrays, one entry per lane. The running and IO-serviced
+  // processes' counters and both queues' head/length live here.
+  std::vector<int32_t> tick, alive, procCount, arrived, nextArrival;
+  std::vector<int32_t> runSlot, runRemain, runLastIO, runRate, q;
+  std::vector<int32_t> ioSlot, countIOBurst, burstTimeIO;
+  std::vector<int32_t> readyHead, readyLen, ioHead, ioQLen, laneOffset;
+
+  // Per-process tables and queue rings, lane i owning the `stride` entries
+  // from laneOffset[i]; the kernel reaches them by gather and scatter.
+  std::vector<int32_t> arrivalTab, burstRemainTab, lastIOTab, rateTab;
+  std::vector<int32_t> burstIOTab, startTab, completionTab;
+  std::vector<int32_t> readyRing, ioRing;
+
+  // Advance simd::width lanes by one step. Lanes whose next event is k > 0
+  // ticks away only see counters move, so they jump k ticks at once; the
+  // rest run one full tick as masked vector code, arrivals through IO.
+  void advanceChunk(size_t base) {
+    using namespace simd;
+    const V one = set1(1), zero = set1(0), none = set1(noProc);
+    const V quantum = set1(timeQuantum), wrap = set1(stride - 1);
+    V t = load(&tick[base]), live = load(&alive[base]);
+    V count = load(&procCount[base]), seen = load(&arrived[base]);
+    V arrive = load(&nextArrival[base]), run = load(&runSlot[base]);
+    V rem = load(&runRemain[base]), lio = load(&runLastIO[base]);
+    V rate = load(&runRate[base]), qv = load(&q[base]);
+    V io = load(&ioSlot[base]), ioc = load(&countIOBurst[base]);
+    V iob = load(&burstTimeIO[base]);
+    V rHead = load(&readyHead[base]), rLen = load(&readyLen[base]);
+    V iHead = load(&ioHead[base]), iLen = load(&ioQLen[base]);
+
+    M active = gt(live, zero);
+    M busy = gt(run, none), ioBusy = gt(io, none);
+    M ready = gt(rLen, zero), ioWait = gt(iLen, zero);
+
+    V cpuSlack = min(sub(rem, one), sub(sub(rate, one), lio));
+    cpuSlack = select(ready, min(cpuSlack, sub(sub(quantum, one), qv)), cpuSlack);
+    V slack = sub(arrive, t);
+    slack = select(busy, min(slack, cpuSlack), slack);
+    slack = select(ioBusy, min(slack, sub(sub(iob, one), ioc)), slack);
+    M fast = but(both(active, gt(slack, zero)),
+                 either(but(ready, busy), but(ioWait, ioBusy)));
+    V skip = select(fast, slack, zero);
+    t = add(t, skip);
+    qv = add(qv, skip);
+    rem = sub(rem, select(busy, skip, zero));
+    lio = add(lio, select(busy, skip, zero));
+    ioc = add(ioc, select(ioBusy, skip, zero));
+
+    M ev = but(active, fast);
+    uint32_t finished = 0;
+    if (bits(ev)) {
+      V off = load(&laneOffset[base]);
+
+      M arriving = both(ev, ge(t, arrive));
+      while (bits(arriving)) {
+        scatter(arriving, readyRing.data(), add(off, band(add(rHead, rLen), wrap)),
+                seen);
+        rLen = select(arriving, add(rLen, one), rLen);
+        seen = select(arriving, add(seen, one), seen);
+        M more = both(arriving, gt(count, seen));
+        arrive = select(arriving,
+                        gather(more, set1(noArrival), arrivalTab.data(),
+                               add(off, seen)),
+                        arrive);
+        arriving = both(arriving, ge(t, arrive));
+      }
+
+      M exec = both(ev, busy);
+      rem = select(exec, sub(rem, one), rem);
+      M done = both(exec, eq(rem, zero));
+      scatter(done, completionTab.data(), add(off, run), t);
+      live = select(done, sub(live, one), live);
+      M last = both(done, eq(live, zero));
+      M cont = but(exec, done);
+      lio = select(cont, add(lio, one), lio);
+      M blocked = both(cont, ge(lio, rate));
+      scatter(blocked, burstRemainTab.data(), add(off, run), rem);
+      scatter(blocked, lastIOTab.data(), add(off, run), zero);
+      scatter(blocked, ioRing.data(), add(off, band(add(iHead, iLen), wrap)), run);
+      iLen = select(blocked, add(iLen, one), iLen);
+      run = select(either(done, blocked), none, run);
+      ev = but(ev, last);
+
+      M idle = both(ev, eq(run, none));
+      M sched = both(both(ev, gt(rLen, zero)),
+                     either(idle, ge(add(qv, one), quantum)));
+      V next = gather(sched, none, readyRing.data(), add(off, rHead));
+      rHead = select(sched, band(add(rHead, one), wrap), rHead);
+      rLen = select(sched, sub(rLen, one), rLen);
+      M preempt = but(sched, idle);
+      scatter(preempt, burstRemainTab.data(), add(off, run), rem);
+      scatter(preempt, lastIOTab.data(), add(off, run), lio);
+      scatter(preempt, readyRing.data(), add(off, band(add(rHead, rLen), wrap)),
+              run);
+      rLen = select(preempt, add(rLen, one), rLen);
+      run = select(sched, next, run);
+      V at = add(off, next);
+      rem = gather(sched, rem, burstRemainTab.data(), at);
+      lio = gather(sched, lio, lastIOTab.data(), at);
+      rate = gather(sched, rate, rateTab.data(), at);
+      scatter(sched, startTab.data(), at,
+              min(gather(sched, t, startTab.data(), at), t));
+      qv = select(sched, none, qv);
+
+      M ioRun = both(ev, gt(io, none));
+      ioc = select(ioRun, add(ioc, one), ioc);
+      M ioDone = both(ioRun, ge(ioc, iob));
+      scatter(ioDone, readyRing.data(), add(off, band(add(rHead, rLen), wrap)),
+              io);
+      rLen = select(ioDone, add(rLen, one), rLen);
+      io = select(ioDone, none, io);
+      M ioStart = both(both(ev, eq(io, none)), gt(iLen, zero));
+      io = gather(ioStart, io, ioRing.data(), add(off, iHead));
+      iHead = select(ioStart, band(add(iHead, one), wrap), iHead);
+      iLen = select(ioStart, sub(iLen, one), iLen);
+      ioc = select(ioStart, zero, ioc);
+      iob = gather(ioStart, iob, burstIOTab.data(), add(off, io));
+
+      t = select(ev, add(t, one), t);
+      qv = select(ev, add(qv, one), qv);
+      finished = bits(last);
+    }
+
+    store(&tick[base], t);
+    store(&alive[base], live);
+    store(&arrived[base], seen);
+    store(&nextArrival[base], arrive);
+    store(&runSlot[base], run);
+    store(&runRemain[base], rem);
+    store(&runLastIO[base], lio);
+    store(&runRate[base], rate);
+    store(&q[base], qv);
+    store(&ioSlot[base], io);
+    store(&countIOBurst[base], ioc);
+    store(&burstTimeIO[base], iob);
+    store(&readyHead[base], rHead);
+    store(&readyLen[base], rLen);
+    store(&ioHead[base], iHead);
+    store(&ioQLen[base], iLen);
+    for (; finished; finished &= finished - 1) {
+      refill(base + __builtin_ctz(finished));
+    }
+  }
+
+  void pushReady(size_t i, int32_t proc) {
+    readyRing[laneOffset[i] + ((readyHead[i] + readyLen[i]++) & (stride - 1))] =
+        proc;
+  }
+
+  // One full rr.cpp tick for a single lane: arrivals, CPU burst, dispatch,
+  // then the IO device.
+  void processor(size_t i) {
+    int32_t off = laneOffset[i], now = tick[i];
+    std::ostream* trace = traceOf[i]->log;
+    const std::vector<std::string>& name = traceOf[i]->procName;
+
+    LOG_TICK(now)
+    if (runSlot[i] == noProc) {
+      LOG("\t", "CPU", "-")
+    }
+    while (arrived[i] < procCount[i] && arrivalTab[off + arrived[i]] <= now) {
+      LOG("\t", "CPU", name[arrived[i]] << "[Arrive]")
+      pushReady(i, arrived[i]++);
+    }
+    nextArrival[i] =
+        arrived[i] < procCount[i] ? arrivalTab[off + arrived[i]] : noArrival;
+
+    int32_t proc = runSlot[i];
+    if (proc != noProc) {
+      if (--runRemain[i] == 0) {
+        LOG("\t", "CPU", name[proc] << "[Comp]")
+        completionTab[off + proc] = now;
+        runSlot[i] = noProc;
+        if (--alive[i] == 0) {
+          LOG_TICK("\n")
+          refill(i);
+          return;
+        }
+      } else if (++runLastIO[i] >= runRate[i]) {
+        LOG("\t", "CPU", name[proc] << "[Q IO]:" << runRemain[i])
+        burstRemainTab[off + proc] = runRemain[i];
+        lastIOTab[off + proc] = 0;
+        ioRing[off + ((ioHead[i] + ioQLen[i]++) & (stride - 1))] = proc;
+        runSlot[i] = noProc;
+      } else {
+        LOG("\t", "CPU", name[proc] << ":" << runRemain[i])
+      }
+    }
+
+    if (readyLen[i] && (runSlot[i] == noProc || q[i] + 1 >= timeQuantum)) {
+      int32_t next = readyRing[off + readyHead[i]];
+      readyHead[i] = (readyHead[i] + 1) & (stride - 1);
+      readyLen[i]--;
+      if (runSlot[i] != noProc) {
+        LOG("\t", "CPU", name[runSlot[i]] << "[Preempt]->" << name[next])
+        burstRemainTab[off + runSlot[i]] = runRemain[i];
+        lastIOTab[off + runSlot[i]] = runLastIO[i];
+        pushReady(i, runSlot[i]);
+      } else {
+        LOG("\t", "CPU", name[next] << "[Sched]")
+      }
+      runSlot[i] = next;
+      runRemain[i] = burstRemainTab[off + next];
+      runLastIO[i] = lastIOTab[off + next];
+      runRate[i] = rateTab[off + next];
+      startTab[off + next] = std::min(startTab[off + next], now);
+      q[i] = -1;
+    }
+
+    if (ioSlot[i] != noProc) {
+      if (++countIOBurst[i] >= burstTimeIO[i]) {
+        LOG("\t", "IO", name[ioSlot[i]] << "[Comp]:" << countIOBurst[i])
+        pushReady(i, ioSlot[i]);
+        ioSlot[i] = noProc;
+      } else {
+        LOG("\t", "IO", name[ioSlot[i]] << ":" << countIOBurst[i])
+      }
+    }
+    if (ioSlot[i] == noProc && ioQLen[i]) {
+      ioSlot[i] = ioRing[off + ioHead[i]];
+      ioHead[i] = (ioHead[i] + 1) & (stride - 1);
+      ioQLen[i]--;
+      countIOBurst[i] = 0;
+      burstTimeIO[i] = burstIOTab[off + ioSlot[i]];
+      LOG("\t", "IO", name[ioSlot[i]] << "[Sched]:" << countIOBurst[i])
+    }
+
+    tick[i]++;
+    q[i]++;
+    LOG_TICK("\n")
+  }
+
+  // Hand lane i's results back to its trace, then load the next unclaimed
+  // trace into it or park it.
+  void refill(size_t i) {
+    size_t off = laneOffset[i];
+    if (Trace* done = traceOf[i]) {
+      std::copy_n(&startTab[off], done->size(), done->startTime.begin());
+      std::copy_n(&completionTab[off], done->size(),
+                  done->completionTime.begin());
+      traceOf[i] = nullptr;
+      activeLanes--;
+    }
+    while (nextTrace < traces->size() && !(*traces)[nextTrace].size()) {
+      nextTrace++;
+    }
+    if (nextTrace == traces->size()) {
+      alive[i] = 0;
+      return;
+    }
+    Trace& trace = (*traces)[nextTrace++];
+    traceOf[i] = &trace;
+    activeLanes++;
+    if (std::ostream* log = trace.log) {
+      *log << "Time (tick)\tDevice\t\tProcess Served\n";
+    }
+    std::copy(trace.arrivalTime.begin(), trace.arrivalTime.end(), &arrivalTab[off]);
+    std::copy(trace.burstTimeCPU.begin(), trace.burstTimeCPU.end(),
+              &burstRemainTab[off]);
+    std::copy(trace.burstTimeRate.begin(), trace.burstTimeRate.end(), &rateTab[off]);
+    std::copy(trace.burstTimeIO.begin(), trace.burstTimeIO.end(), &burstIOTab[off]);
+    std::fill_n(&lastIOTab[off], trace.size(), 0);
+    std::fill_n(&startTab[off], trace.size(), INT32_MAX);
+
+    tick[i] = 0;
+    alive[i] = procCount[i] = trace.size();
+    arrived[i] = 0;
+    nextArrival[i] = trace.arrivalTime[0];
+    runSlot[i] = ioSlot[i] = noProc;
+    runRemain[i] = runLastIO[i] = runRate[i] = q[i] = 0;
+    countIOBurst[i] = burstTimeIO[i] = 0;
+    readyHead[i] = readyLen[i] = ioHead[i] = ioQLen[i] = 0;
+  }
+};
+
+// Function to build processes from trace entries
+Processes toProcesses(TraceEntries& entries) {
+  Processes processes;
+  for (auto& entry : entries) {
+    auto& f = entry.fields;
+    processes.push_back(
+        Process(std::move(entry.name), f[0], f[1], f[2], f[3]));
+  }
+  return processes;
+}
+
+// Small random traces for Monte-Carlo runs, seeded so runs are repeatable.
+Traces randomTraces(size_t count, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  auto pick = [&rng](size_t lo, size_t hi) {
+    return std::uniform_int_distribution<size_t>(lo, hi)(rng);
+  };
+  Traces traces;
+  for (size_t t = 0; t < count; t++) {
+    Processes procs;
+    size_t n = pick(2, 8);
+    for (size_t p = 0; p < n; p++) {
+      procs.push_back(Process("P" + std::to_string(p), pick(0, 30), pick(1, 60),
+                              pick(0, 6), pick(1, 10)));
+    }
+    traces.push_back(Trace("mc" + std::to_string(t), procs));
+  }
+  return traces;
+}
+
+double timeRun(Traces& traces, bool batched, int32_t timeQuantum) {
+  auto begin = std::chrono::steady_clock::now();
+  BatchDevice d(batched ? 64 : 1, batched, timeQuantum);
+  d.run(traces);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  return elapsed.count();
+}
+
+}  // namespace
+
+int batchRR(const SchedOptions& opts,
+            const std::vector<std::string>& paths,
+            std::vector<Report>& reports) {
+  if (opts.cpus != 1 || opts.ios != 1) {
+    std::cerr << "batch: only one CPU and one IO device are modelled"
+              << std::endl;
+    return 1;
+  }
+
+  // Replay every trace in one batch
+  Traces traces;
+  for (auto& path : paths) {
+    // Lanes hold int32 fields, so larger values are rejected, not wrapped
+    TraceEntries entries;
+    if (!readTrace(path, 4, INT32_MAX, entries)) {
+      return 1;
+    }
+    Processes procs = toProcesses(entries);
+    if (procs.empty()) {
+      std::cerr << "No processes were read from " << path << std::endl;
+      return 1;
+    }
+    traces.push_back(Trace(std::string(path), procs));
+  }
+  // Tick logs need every tick, so logged runs step lanes one at a time
+  bool logged = false;
+  for (size_t t = 0; t < traces.size(); t++) {
+    traces[t].log = reports[t].trace;
+    logged = logged || traces[t].log;
+  }
+  // Every lane gets a stride-sized slice of each table, so a few large
+  // traces must not pay for 64 lanes
+  BatchDevice d(std::min<size_t>(64, traces.size()), !logged,
+                opts.timeQuantum);
+  d.run(traces);
+
+  for (size_t t = 0; t < traces.size(); t++) {
+    Trace& trace = traces[t];
+    Report& report = reports[t];
+    std::ostream* out = report.out;
+    for (size_t p = 0; p < trace.size(); p++) {
+      if (out && opts.logLevel >= LOG_PROCESS) {
+        LOG_DEBUG(trace.procName[p], "Arrival Time:\t", trace.arrivalTime[p])
+        LOG_DEBUG("", "Start Time:\t", trace.startTime[p])
+        LOG_DEBUG("", "Response Time:\t",
+                  trace.startTime[p] - trace.arrivalTime[p])
+        LOG_DEBUG("", "Completion Time:", trace.completionTime[p])
+        LOG_DEBUG("", "Turnaround Time:",
+                  trace.completionTime[p] - trace.arrivalTime[p])
+        LOG_DEBUG("", "Waiting Time:\t", trace.waitingTime(p) << "\n")
+      }
+      report.addProcess(trace.procName[p], trace.arrivalTime[p],
+                        trace.burstTimeCPU[p], trace.startTime[p],
+                        trace.completionTime[p], trace.waitingTime(p));
+    }
+    report.addMetric("avgWaitingTime", trace.avgWaitingTime());
+    if (out) {
+      *out << "Avg Waiting Time: " << trace.avgWaitingTime();
+    }
+  }
+  return 0;
+}
+
+int batchBench(const SchedOptions& opts, size_t count) {
+  // Measure lockstep replay against rr's own engine running the traces one
+  // after another, and against this engine's one-lane path
+  Traces scalar = randomTraces(count, 1), batched = scalar;
+  std::vector<std::string> texts;
+  for (auto& trace : scalar) {
+    std::ostringstream text;
+    for (size_t i = 0; i < trace.size(); i++) {
+      text << trace.procName[i] << ";" << trace.arrivalTime[i] << ";"
+           << trace.burstTimeCPU[i] << ";" << trace.burstTimeIO[i] << ";"
+           << trace.burstTimeRate[i] << "\n";
+    }
+    texts.push_back(text.str());
+  }
+  SchedOptions rrOpts = opts;
+  rrOpts.cpus = rrOpts.ios = 1;
+  double rrSeconds = rrTime(rrOpts, texts);
+  if (rrSeconds < 0) {
+    return 1;
+  }
+  double scalarTime = timeRun(scalar, false, opts.timeQuantum);
+  double batchTime = timeRun(batched, true, opts.timeQuantum);
+  for (size_t t = 0; t < scalar.size(); t++) {
+    if (scalar[t].completionTime != batched[t].completionTime ||
+        scalar[t].startTime != batched[t].startTime) {
+      std::cerr << "Mismatch on trace " << scalar[t].traceName << std::endl;
+      return 1;
+    }
+  }
+  std::cout << "Lanes per vector: " << simd::width << "\n";
+  std::cout << "Traces: " << scalar.size() << "\n";
+  std::cout << "rr engine: " << scalar.size() / rrSeconds << " sims/s\n";
+  std::cout << "Single lane: " << scalar.size() / scalarTime << " sims/s\n";
+  std::cout << "Batched: " << batched.size() / batchTime << " sims/s\n";
+  std::cout << "Speedup over rr: " << rrSeconds / batchTime << "x\n";
+  std::cout << "Speedup over single lane: " << scalarTime / batchTime << "x\n";
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include <string.h>
+
+#include "counters.h"
+
+#ifdef SCHED_COUNTERS
+
+__thread struct SchedCounters schedCounters;
+
+static const char *queueNames[QUEUE_COUNT] = {"readyQ", "ioQ", "auxQ"};
+static const char *phaseNames[PHASE_COUNT] = {"arrival", "dispatch", "io"};
+
+void schedCountersTake(struct SchedCounters *into)
+{
+    *into = schedCounters;
+    memset(&schedCounters, 0, sizeof(schedCounters));
+}
+
+static void printCounters(FILE *out, const struct SchedCounters *c)
+{
+    fprintf(out, "{\"ticks\": %llu, \"contextSwitches\": %llu, "
+                 "\"preemptions\": %llu, \"idleTicks\": %llu, "
+                 "\"ioStalls\": %llu, \"queues\": {",
+            c->ticks, c->contextSwitches, c->preemptions, c->idleTicks,
+            c->ioStalls);
+    for (int q = 0; q < QUEUE_COUNT; q++)
+    {
+        fprintf(out, "%s\"%s\": {\"pushes\": %llu, \"pops\": %llu, "
+                     "\"maxDepth\": %llu}",
+                q ? ", " : "", queueNames[q], c->pushes[q], c->pops[q],
+                c->maxDepth[q]);
+    }
+    fprintf(out, "}");
+#ifdef SCHED_TIMERS
+    fprintf(out, ", \"cycles\": {");
+    for (int p = 0; p < PHASE_COUNT; p++)
+    {
+        fprintf(out, "%s\"%s\": %llu", p ? ", " : "", phaseNames[p],
+                c->cycles[p]);
+    }
+    fprintf(out, "}");
+#else
+    (void)phaseNames;
+#endif
+    fprintf(out, "}");
+}
+
+void schedCountersJSON(FILE *out, const struct SchedCounters *threads, size_t count)
+{
+    struct SchedCounters total;
+    memset(&total, 0, sizeof(total));
+    fprintf(out, "{\"threads\": [");
+    for (size_t t = 0; t < count; t++)
+    {
+        const struct SchedCounters *c = &threads[t];
+        fprintf(out, t ? ",\n  " : "\n  ");
+        printCounters(out, c);
+        total.ticks += c->ticks;
+        total.contextSwitches += c->contextSwitches;
+        total.preemptions += c->preemptions;
+        total.idleTicks += c->idleTicks;
+        total.ioStalls += c->ioStalls;
+        for (int q = 0; q < QUEUE_COUNT; q++)
+        {
+            total.pushes[q] += c->pushes[q];
+            total.pops[q] += c->pops[q];
+            if (c->maxDepth[q] > total.maxDepth[q])
+            {
+                total.maxDepth[q] = c->maxDepth[q];
+            }
+        }
+        for (int p = 0; p < PHASE_COUNT; p++)
+        {
+            total.cycles[p] += c->cycles[p];
+        }
+    }
+    fprintf(out, "],\n \"total\": ");
+    printCounters(out, &total);
+    fprintf(out, "}\n");
+}
+
+#endif
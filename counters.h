@@ -0,0 +1,82 @@
+#ifndef COUNTERS_H
+#define COUNTERS_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Hot-path counters for the tick loops, kept per thread. Build with
+// -DSCHED_COUNTERS to turn them on, and -DSCHED_TIMERS to also time the
+// arrival, dispatch and IO phases with rdtsc (x86 only). Without those
+// flags every macro below expands to nothing.
+
+enum SchedQueue { QUEUE_READY, QUEUE_IO, QUEUE_AUX, QUEUE_COUNT };
+enum SchedPhase { PHASE_ARRIVAL, PHASE_DISPATCH, PHASE_IO, PHASE_COUNT };
+
+struct SchedCounters {
+  unsigned long long ticks;
+  unsigned long long contextSwitches;
+  unsigned long long preemptions;
+  unsigned long long idleTicks;  // per CPU, ticks with nothing to run
+  unsigned long long ioStalls;   // idle ticks while a process waits on IO
+  unsigned long long pushes[QUEUE_COUNT];
+  unsigned long long pops[QUEUE_COUNT];
+  unsigned long long maxDepth[QUEUE_COUNT];
+  unsigned long long cycles[PHASE_COUNT];
+};
+
+#if defined(SCHED_TIMERS) && !defined(SCHED_COUNTERS)
+#define SCHED_COUNTERS
+#endif
+
+#ifdef SCHED_COUNTERS
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern __thread struct SchedCounters schedCounters;
+
+// Moves this thread's counters into `into` and clears them.
+void schedCountersTake(struct SchedCounters* into);
+// Writes each thread's counters and their totals as one JSON object.
+void schedCountersJSON(FILE* out,
+                       const struct SchedCounters* threads,
+                       size_t count);
+#ifdef __cplusplus
+}
+#endif
+
+#define COUNT(field) (schedCounters.field++)
+#define COUNT_ADD(field, n) (schedCounters.field += (n))
+#define COUNT_IF(field, cond) \
+  do {                        \
+    if (cond) {               \
+      schedCounters.field++;  \
+    }                         \
+  } while (0)
+#define COUNT_PUSH(queue, depth)                       \
+  do {                                                 \
+    unsigned long long depth_ = (depth);               \
+    schedCounters.pushes[queue]++;                     \
+    if (depth_ > schedCounters.maxDepth[queue]) {      \
+      schedCounters.maxDepth[queue] = depth_;          \
+    }                                                  \
+  } while (0)
+#define COUNT_POP(queue) (schedCounters.pops[queue]++)
+#else
+#define COUNT(field) ((void)0)
+#define COUNT_ADD(field, n) ((void)0)
+#define COUNT_IF(field, cond) ((void)0)
+#define COUNT_PUSH(queue, depth) ((void)0)
+#define COUNT_POP(queue) ((void)0)
+#endif
+
+#ifdef SCHED_TIMERS
+#include <x86intrin.h>
+#define TIME_BEGIN(phase) unsigned long long phase##_begin = __rdtsc();
+#define TIME_END(phase) \
+  schedCounters.cycles[phase] += __rdtsc() - phase##_begin;
+#else
+#define TIME_BEGIN(phase)
+#define TIME_END(phase)
+#endif
+
+#endif
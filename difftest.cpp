@@ -0,0 +1,535 @@
+// Differential tester: runs seeded random traces through the reference
+// engines and the optimized ones and reports the first disagreement, shrunk
+// to a minimal trace.
+//
+//   rr.cpp Device        vs  batch_rr.cpp one lane at a time: tick logs
+//                            (the event stream), start and completion times
+//   rr.cpp Device        vs  batch_rr.cpp SIMD lanes: start and completion
+//   sjf.c, srtf.c            no optimized engine yet; every run is checked
+//                            against the invariants any schedule must keep
+//
+// Build:
+//   gcc -O2 -c sjf.c srtf.c counters.c
+//   g++ -std=c++17 -O2 -march=native -pthread -o difftest difftest.cpp rr.cpp
+//       vrr.cpp lottery.cpp stride.cpp share.cpp edf.cpp rm.cpp periodic.cpp
+//       batch_rr.cpp trace.cpp sjf.o srtf.o counters.o
+//
+// Example:
+//   ./difftest -n 20000 -s 7     exit status 0 when every case agrees
+//
+// Cases are handed to the engines as trace files under $TMPDIR (default
+// /tmp); a tmpfs there keeps large runs fast.
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "policies.h"
+
+namespace {
+
+typedef struct Task {
+  std::string name;
+  long arrivalTime;
+  long burstTimeCPU;
+  long burstTimeIO;
+  long burstTimeRate;
+} Task;
+typedef std::vector<Task> Case;
+
+// Random traces leaning on the edges: simultaneous arrivals, zero-length
+// IO, IO after every tick, and bursts equal to (or a multiple of) the
+// quantum.
+class Generator {
+ public:
+  Generator(uint64_t seed, long timeQuantum) : rng(seed) {
+    this->timeQuantum = timeQuantum;
+  }
+
+  Case next() {
+    Case c;
+    bool crowded = pick(0, 2) == 0;
+    long n = pick(1, 8);
+    for (long p = 0; p < n; p++) {
+      Task task;
+      task.name = "P" + std::to_string(p);
+      task.arrivalTime = crowded ? pick(0, 2) : pick(0, 30);
+      switch (pick(0, 3)) {
+        case 0:
+          task.burstTimeCPU = timeQuantum * pick(1, 3);
+          break;
+        case 1:
+          task.burstTimeCPU = pick(1, 3);
+          break;
+        default:
+          task.burstTimeCPU = pick(1, 40);
+      }
+      task.burstTimeIO = pick(0, 3) == 0 ? 0 : pick(1, 6);
+      switch (pick(0, 4)) {
+        case 0:
+          task.burstTimeRate = timeQuantum;
+          break;
+        case 1:
+          task.burstTimeRate = pick(0, 1);
+          break;
+        default:
+          task.burstTimeRate = pick(2, 12);
+      }
+      c.push_back(task);
+    }
+    return c;
+  }
+
+ private:
+  std::mt19937_64 rng;
+  long timeQuantum;
+
+  long pick(long lo, long hi) {
+    return std::uniform_int_distribution<long>(lo, hi)(rng);
+  }
+};
+
+std::string format(const Case& c) {
+  std::ostringstream s;
+  for (auto& task : c) {
+    s << task.name << ";" << task.arrivalTime << ";" << task.burstTimeCPU << ";"
+      << task.burstTimeIO << ";" << task.burstTimeRate << "\n";
+  }
+  return s.str();
+}
+
+// Cases reach the engines the way the driver's do, as trace files. Without
+// somewhere to put them no result means anything, so failing to create or
+// write a file ends the run.
+class Scratch {
+ public:
+  Scratch() {
+    const char* tmp = getenv("TMPDIR");
+    std::string pattern = std::string(tmp ? tmp : "/tmp") + "/difftest.XXXXXX";
+    std::vector<char> buf(pattern.begin(), pattern.end());
+    buf.push_back('\0');
+    if (!mkdtemp(buf.data())) {
+      std::cerr << "difftest: cannot create " << pattern << ": "
+                << strerror(errno) << "\n";
+      exit(1);
+    }
+    dir = buf.data();
+  }
+  ~Scratch() { clear(); }
+
+  // Writes one trace file per case and names them. Call it before forking,
+  // so the files are removed at exit whatever the child does.
+  std::vector<std::string> write(const std::vector<Case>& cases) {
+    while (paths.size() < cases.size()) {
+      paths.push_back(dir + "/" + std::to_string(paths.size()) + ".txt");
+    }
+    for (size_t i = 0; i < cases.size(); i++) {
+      std::ofstream file(paths[i]);
+      file << format(cases[i]);
+      file.close();
+      if (!file) {
+        std::cerr << "difftest: cannot write " << paths[i] << "\n";
+        clear();
+        exit(1);
+      }
+    }
+    return std::vector<std::string>(paths.begin(),
+                                    paths.begin() + cases.size());
+  }
+
+ private:
+  std::string dir;
+  std::vector<std::string> paths;
+
+  void clear() {
+    for (auto& path : paths) {
+      unlink(path.c_str());
+    }
+    paths.clear();
+    rmdir(dir.c_str());
+  }
+};
+
+// Which start/completion a report gives each process, by name.
+std::map<std::string, std::pair<long, long>> timesOf(const Report& report) {
+  std::map<std::string, std::pair<long, long>> times;
+  for (auto& proc : report.procs) {
+    times[proc.name] = {proc.startTime, proc.completionTime};
+  }
+  return times;
+}
+
+std::string compareTimes(const char* engine,
+                         const Report& reference,
+                         const Report& report) {
+  auto want = timesOf(reference), got = timesOf(report);
+  for (auto& entry : want) {
+    auto it = got.find(entry.first);
+    if (it == got.end()) {
+      return std::string(engine) + ": " + entry.first + " never completed";
+    }
+    if (it->second != entry.second) {
+      std::ostringstream s;
+      s << engine << ": " << entry.first << " start/completion "
+        << it->second.first << "/" << it->second.second << ", reference "
+        << entry.second.first << "/" << entry.second.second;
+      return s.str();
+    }
+  }
+  if (got.size() != want.size()) {
+    return std::string(engine) + ": reports processes the reference does not";
+  }
+  return "";
+}
+
+std::string compareLogs(const std::string& reference, const std::string& log) {
+  std::istringstream want(reference), got(log);
+  std::string wantLine, gotLine;
+  for (size_t line = 1;; line++) {
+    bool more = (bool)std::getline(want, wantLine);
+    bool gotMore = (bool)std::getline(got, gotLine);
+    if (!more && !gotMore) {
+      return "";
+    }
+    if (more != gotMore || wantLine != gotLine) {
+      std::ostringstream s;
+      s << "batch lanes: tick log line " << line << " is '"
+        << (gotMore ? gotLine : "<end>") << "', reference '"
+        << (more ? wantLine : "<end>") << "'";
+      return s.str();
+    }
+  }
+}
+
+// Invariants of any single-CPU schedule, for engines with nothing to diff
+// against.
+std::string checkInvariants(const char* engine,
+                            const Case& c,
+                            const Report& report) {
+  if (report.procs.size() != c.size()) {
+    return std::string(engine) + ": not every process completed";
+  }
+  for (auto& proc : report.procs) {
+    std::string fault;
+    if (proc.completionTime < proc.arrivalTime + proc.burstTime) {
+      fault = "completed before its burst could run";
+    } else if (proc.turnaroundTime != proc.completionTime - proc.arrivalTime) {
+      fault = "turnaround is not completion - arrival";
+    } else if (proc.responseTime < 0 ||
+               proc.responseTime > proc.turnaroundTime - proc.burstTime) {
+      fault = "response time out of range";
+    } else if (proc.waitingTime < 0 ||
+               proc.waitingTime > proc.turnaroundTime - proc.burstTime) {
+      fault = "waiting time out of range";
+    }
+    if (!fault.empty()) {
+      return std::string(engine) + ": " + proc.name + " " + fault;
+    }
+  }
+  return "";
+}
+
+void addProcess(void* ctx, const SchedProc* proc) {
+  static_cast<Report*>(ctx)->procs.push_back(*proc);
+}
+
+void addMetric(void* ctx, const char* name, double value) {
+  static_cast<Report*>(ctx)->addMetric(name, value);
+}
+
+int runC(int (*policy)(const SchedOptions*, SchedReport*),
+         const SchedOptions& opts,
+         Report& report) {
+  SchedReport cReport = {nullptr, nullptr, &report, addProcess, addMetric};
+  return policy(&opts, &cReport);
+}
+
+const long unknownCase = -2;
+
+class DiffTest {
+ public:
+  DiffTest(const SchedOptions& opts, int timeoutMs) {
+    this->opts = opts;
+    this->timeoutMs = timeoutMs;
+  }
+
+  // Runs a round of cases through every engine; returns the index of the
+  // first failing case and why, or -1. The round runs in a child process so
+  // an engine that crashes or never finishes fails its case instead of
+  // taking the harness down; such a case is found by bisecting the round.
+  // If no half fails again on its own, returns unknownCase: the failure
+  // is flaky, and no case is to blame.
+  long round(const std::vector<Case>& cases, std::string& why) {
+    long failed = isolated(cases, why);
+    if (failed != unknownCase) {
+      return failed;
+    }
+    if (cases.size() == 1) {
+      return 0;
+    }
+    size_t half = cases.size() / 2;
+    std::vector<Case> left(cases.begin(), cases.begin() + half);
+    std::vector<Case> right(cases.begin() + half, cases.end());
+    std::string bisectWhy;
+    if ((failed = round(left, bisectWhy)) >= 0) {
+      why = bisectWhy;
+      return failed;
+    }
+    if ((failed = round(right, bisectWhy)) >= 0) {
+      why = bisectWhy;
+      return half + failed;
+    }
+    return unknownCase;
+  }
+
+  std::string check(const Case& c) {
+    std::string why;
+    round({c}, why);
+    return why;
+  }
+
+  // Greedy shrinking: drop processes, then pull each field toward its
+  // smallest legal value, keeping every step that still fails.
+  Case shrink(Case c, std::string& why) {
+    for (bool progress = true; progress;) {
+      progress = false;
+      for (size_t p = 0; p < c.size() && c.size() > 1; p++) {
+        Case smaller = c;
+        smaller.erase(smaller.begin() + p);
+        if (accept(smaller, c, why)) {
+          progress = true;
+          p--;
+        }
+      }
+      for (size_t p = 0; p < c.size(); p++) {
+        for (auto field : {&Task::arrivalTime, &Task::burstTimeCPU,
+                           &Task::burstTimeIO, &Task::burstTimeRate}) {
+          long floor = field == &Task::burstTimeCPU ? 1 : 0;
+          for (long value : {floor, c[p].*field / 2, c[p].*field - 1}) {
+            if (value < floor || value >= c[p].*field) {
+              continue;
+            }
+            Case smaller = c;
+            smaller[p].*field = value;
+            if (accept(smaller, c, why)) {
+              progress = true;
+              break;
+            }
+          }
+        }
+      }
+    }
+    for (size_t p = 0; p < c.size(); p++) {
+      Case renamed = c;
+      renamed[p].name = "P" + std::to_string(p);
+      accept(renamed, c, why);
+    }
+    return c;
+  }
+
+ private:
+  SchedOptions opts;
+  int timeoutMs;
+  Scratch scratch;
+
+  bool accept(const Case& candidate, Case& c, std::string& why) {
+    std::string fault = check(candidate);
+    if (fault.empty()) {
+      return false;
+    }
+    c = candidate;
+    why = fault;
+    return true;
+  }
+
+  // The comparison itself, in this process.
+  long compare(const std::vector<Case>& cases,
+               const std::vector<std::string>& paths,
+               std::string& why) {
+    size_t n = cases.size();
+    std::vector<Report> reference(n), lanes(n), vector(n);
+    std::vector<std::ostringstream> referenceLog(n), lanesLog(n);
+    std::vector<std::string> failure(n);
+
+    for (size_t i = 0; i < n; i++) {
+      SchedOptions caseOpts = opts;
+      caseOpts.trace = paths[i].c_str();
+      reference[i].trace = &referenceLog[i];
+      lanes[i].trace = &lanesLog[i];
+      if (rr(caseOpts, reference[i])) {
+        failure[i] = "rr: failed to run";
+        continue;
+      }
+
+      for (auto policy : {std::make_pair("sjf", sjf),
+                          std::make_pair("srtf", srtf)}) {
+        Report report;
+        if (failure[i].empty() && runC(policy.second, caseOpts, report)) {
+          failure[i] = std::string(policy.first) + ": failed to run";
+        }
+        if (failure[i].empty()) {
+          failure[i] = checkInvariants(policy.first, cases[i], report);
+        }
+      }
+    }
+
+    if (batchRR(opts, paths, lanes) || batchRR(opts, paths, vector)) {
+      why = "batch: failed to run";
+      return unknownCase;
+    }
+    for (size_t i = 0; i < n; i++) {
+      if (failure[i].empty()) {
+        failure[i] = compareLogs(referenceLog[i].str(), lanesLog[i].str());
+      }
+      if (failure[i].empty()) {
+        failure[i] = compareTimes("batch lanes", reference[i], lanes[i]);
+      }
+      if (failure[i].empty()) {
+        failure[i] = compareTimes("batch SIMD", reference[i], vector[i]);
+      }
+      if (!failure[i].empty()) {
+        why = failure[i];
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  long isolated(const std::vector<Case>& cases, std::string& why) {
+    std::vector<std::string> paths = scratch.write(cases);
+    int fds[2];
+    if (pipe(fds)) {
+      return compare(cases, paths, why);
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+      close(fds[0]);
+      long failed = compare(cases, paths, why);
+      std::string result = std::to_string(failed) + "\n" + why;
+      ssize_t sent = write(fds[1], result.data(), result.size());
+      _exit(sent == (ssize_t)result.size() ? 0 : 1);
+    }
+    close(fds[1]);
+
+    std::string result;
+    char buf[512];
+    pollfd readable = {fds[0], POLLIN, 0};
+    bool timedOut = false;
+    for (;;) {
+      if (poll(&readable, 1, timeoutMs) == 0) {
+        timedOut = true;
+        kill(pid, SIGKILL);
+        break;
+      }
+      ssize_t got = read(fds[0], buf, sizeof(buf));
+      if (got <= 0) {
+        break;
+      }
+      result.append(buf, got);
+    }
+    close(fds[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    if (timedOut) {
+      why = "an engine did not finish within " + std::to_string(timeoutMs) +
+            " ms";
+      return unknownCase;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+      why = WIFSIGNALED(status) ? "an engine crashed with signal " +
+                                      std::to_string(WTERMSIG(status))
+                                : "an engine exited early";
+      return unknownCase;
+    }
+    size_t newline = result.find('\n');
+    why = result.substr(newline + 1);
+    return std::stol(result.substr(0, newline));
+  }
+};
+
+void usage(const char* argv0) {
+  std::cerr << "Usage: " << argv0
+            << " [-n cases] [-s seed] [-q quantum] [-t timeout]\n"
+            << "  -n N   number of random cases (default 10000)\n"
+            << "  -s N   generator seed (default 1)\n"
+            << "  -q N   time quantum in ticks (default 5)\n"
+            << "  -t N   milliseconds a round of cases may take (default 2000)\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long cases = 10000, timeQuantum = 5, timeoutMs = 2000;
+  uint64_t seed = 1;
+  int c;
+  while ((c = getopt(argc, argv, "n:s:q:t:h")) != -1) {
+    char* end = nullptr;
+    long long value = optarg ? strtoll(optarg, &end, 10) : 0;
+    if (c == 'h' || c == '?' || !optarg || *end || value < 1) {
+      usage(argv[0]);
+      return c == 'h' ? 0 : 2;
+    }
+    if (c == 'n') {
+      cases = value;
+    } else if (c == 's') {
+      seed = value;
+    } else if (c == 't') {
+      timeoutMs = value;
+    } else {
+      timeQuantum = value;
+    }
+  }
+
+  SchedOptions opts = {};
+  opts.timeQuantum = timeQuantum;
+  opts.cpus = 1;
+  opts.ios = 1;
+  opts.format = FORMAT_TEXT;
+  opts.logLevel = LOG_RESULTS;
+
+  DiffTest test(opts, timeoutMs);
+  Generator gen(seed, timeQuantum);
+  const long roundSize = 256;
+  for (long done = 0; done < cases; done += roundSize) {
+    std::vector<Case> round;
+    for (long i = done; i < std::min(cases, done + roundSize); i++) {
+      round.push_back(gen.next());
+    }
+    std::string why;
+    long failed = test.round(round, why);
+    if (failed == unknownCase) {
+      std::cout << "Flaky round, cases " << done << " to "
+                << done + round.size() - 1 << " (seed " << seed
+                << ", quantum " << timeQuantum << "): " << why
+                << ", but no case fails alone\n";
+      return 1;
+    }
+    if (failed < 0) {
+      continue;
+    }
+    std::cout << "Mismatch in case " << done + failed << " (seed " << seed
+              << ", quantum " << timeQuantum << "): " << why << std::endl;
+    Case minimal = test.shrink(round[failed], why);
+    std::cout << "Minimal trace: " << why << "\n" << format(minimal);
+    return 1;
+  }
+  std::cout << cases << " cases agree (seed " << seed << ", quantum "
+            << timeQuantum << ")\n";
+  return 0;
+}
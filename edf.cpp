@@ -0,0 +1,44 @@
+#include <cstddef>
+#include <ostream>
+
+#include "periodic.h"
+
+namespace {
+
+using periodic::Priority;
+using periodic::Process;
+using periodic::Task;
+using periodic::Tasks;
+
+// Earliest absolute deadline first; ties go to the earlier release, then
+// to the task listed first in the trace.
+Priority priorityOf(const Tasks&, const Process& job, size_t slot) {
+  return {job.absDeadline, job.arrivalTime, job.task, slot};
+}
+
+bool schedulability(const Tasks& tasks, std::ostream& text, Report& report) {
+  double utilization = 0, density = 0;
+  bool implicitDeadlines = true;
+  for (const auto& task : tasks) {
+    utilization += task.utilization();
+    density += task.density();
+    implicitDeadlines = implicitDeadlines && task.deadline >= task.period;
+  }
+  report.addMetric("utilization", utilization);
+  report.addMetric("density", density);
+  text << "Utilization: " << utilization << "\n";
+  if (implicitDeadlines) {
+    text << "EDF Schedulable (U <= 1): " << (utilization <= 1 ? "yes" : "no");
+    return utilization <= 1;
+  }
+  text << "Density: " << density << "\n";
+  text << "EDF Schedulable (density <= 1, sufficient): "
+       << (density <= 1 ? "yes" : "unknown");
+  return density <= 1;
+}
+
+}  // namespace
+
+int edf(const SchedOptions& opts, Report& report) {
+  return periodic::run({"edf", priorityOf, schedulability}, opts, report);
+}
@@ -0,0 +1,84 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "share.h"
+
+namespace {
+
+using share::Processes;
+
+// Fenwick tree over process slots holding the tickets of every READY
+// process, so a draw and a ticket update are both O(log N).
+class TicketTree {
+ public:
+  void init(size_t n) {
+    tree.assign(n + 1, 0);
+    total = 0;
+    topBit = 1;
+    while (topBit * 2 <= n) {
+      topBit *= 2;
+    }
+  }
+  void add(size_t slot, int64_t delta) {
+    total += delta;
+    for (size_t i = slot + 1; i < tree.size(); i += i & (~i + 1)) {
+      tree[i] += delta;
+    }
+  }
+  // Slot owning ticket number `winner`, 0 <= winner < sum().
+  size_t find(uint64_t winner) const {
+    size_t pos = 0;
+    for (size_t step = topBit; step; step /= 2) {
+      if (pos + step < tree.size() && tree[pos + step] <= winner) {
+        pos += step;
+        winner -= tree[pos];
+      }
+    }
+    return pos;
+  }
+  uint64_t sum() const { return total; }
+
+ private:
+  std::vector<uint64_t> tree;
+  uint64_t total = 0;
+  size_t topBit = 1;
+};
+
+class LotterySelector : public share::Selector {
+ public:
+  LotterySelector() : Selector("lottery", "Redraw") {}
+
+  bool init(const Processes& procs) override {
+    this->procs = &procs;
+    readyTickets.init(procs.size());
+    return true;
+  }
+  void join(size_t slot) override { requeue(slot); }
+  void leave(size_t) override {}
+  void requeue(size_t slot) override {
+    readyTickets.add(slot, (*procs)[slot].tickets);
+  }
+  // Draws a ticket from the READY set; its holder wins.
+  size_t pick() override {
+    size_t winner = readyTickets.find(
+        std::uniform_int_distribution<uint64_t>(0, readyTickets.sum() - 1)(
+            rng));
+    readyTickets.add(winner, -(int64_t)(*procs)[winner].tickets);
+    return winner;
+  }
+  void ran(size_t, uint64_t) override {}
+
+ private:
+  const Processes* procs = nullptr;
+  TicketTree readyTickets;
+  std::mt19937_64 rng{1};
+};
+
+}  // namespace
+
+int lottery(const SchedOptions& opts, Report& report) {
+  LotterySelector selector;
+  return share::run(selector, opts, report);
+}
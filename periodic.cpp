@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "periodic.h"
+#include "trace.h"
+
+#define JOB(slot) tasks[jobs[slot].task].taskName << "#" << jobs[slot].jobNo
+
+namespace periodic {
+
+namespace {
+
+// Hyperperiods of co-prime periods explode; releases stop here regardless.
+const size_t maxHorizon = 1000000;
+
+class Device {
+ public:
+  Device() {}
+  void init(const Policy& policy,
+            Tasks& tasks,
+            const SchedOptions& opts,
+            Report& report) {
+    this->policy = &policy;
+    this->tasks = tasks;
+    logProcs = opts.logLevel >= LOG_PROCESS;
+    trace = report.trace;
+    out = report.out;
+    size_t hyperPeriod = 1, maxPhase = 0;
+    for (auto& task : tasks) {
+      size_t a = hyperPeriod, b = task.period;
+      while (b) {
+        a %= b;
+        std::swap(a, b);
+      }
+      hyperPeriod = std::min(hyperPeriod / a * task.period, maxHorizon);
+      maxPhase = std::max(maxPhase, task.phase);
+    }
+    horizon = maxPhase + hyperPeriod;
+    for (size_t i = 0; i < tasks.size(); i++) {
+      if (tasks[i].phase < horizon) {
+        releaseQ.push({tasks[i].phase, i});
+      }
+    }
+  }
+
+  void processor() {
+    LOG("Time (tick)", "Device", "Process Served")
+    while (!releaseQ.empty() || liveJobs) {
+      if (isCPUIdle && isIOIdle && readyQ.empty() && ioQ.empty() &&
+          !releaseQ.empty() && releaseQ.top().first > ticksCPU) {
+        // Nothing can happen before the next release, skip straight to it.
+        LOG_TICK(ticksCPU)
+        LOG("\t", "CPU", "-[Idle]->" << releaseQ.top().first << "\n")
+        ticksCPU = releaseQ.top().first;
+      }
+      LOG_TICK(ticksCPU)
+      if (isCPUIdle) {
+        LOG("\t", "CPU", "-");
+      }
+      FreshArrivals();
+
+      if (!isCPUIdle) {
+        Process& execProc = jobs[execSlot];
+        execProc.exec();
+        if (execProc.state == Process::State::TERMINATED) {
+          LOG("\t", "CPU", JOB(execSlot) << "[Comp]");
+          isCPUIdle = true;
+          execProc.completionTime = ticksCPU;
+          retire(execSlot);
+        } else if (execProc.state == Process::State::BLOCKED) {
+          LOG("\t", "CPU", JOB(execSlot) << "[Q IO]:" << execProc.burstRemainCPU);
+          ioQ.push(execSlot);
+          isCPUIdle = true;
+        } else {
+          LOG("\t", "CPU", JOB(execSlot) << ":" << execProc.burstRemainCPU)
+        }
+      }
+
+      bool toSchedule = !readyQ.empty() &&
+                        (isCPUIdle || readyQ.top() < priorityOf(execSlot));
+      if (toSchedule) {
+        size_t slot = std::get<3>(readyQ.top());
+        readyQ.pop();
+        if (!isCPUIdle) {
+          LOG("\t", "CPU", JOB(execSlot) << "[Preempt]->" << JOB(slot))
+          jobs[execSlot].state = Process::State::READY;
+          readyQ.push(priorityOf(execSlot));
+        } else {
+          LOG("\t", "CPU", JOB(slot) << "[Sched]")
+        }
+        execSlot = slot;
+        jobs[execSlot].state = Process::State::RUNNING;
+        jobs[execSlot].startTime = std::min(jobs[execSlot].startTime, ticksCPU);
+        isCPUIdle = false;
+      }
+
+      ioDevice();
+      ticksCPU++;
+      if (trace) {
+        *trace << "\n";
+      }
+    }
+  }
+
+  void ioDevice() {
+    if (!isIOIdle) {
+      if (++countIOBurst >= jobs[ioSlot].burstTimeIO) {
+        LOG("\t", "IO", JOB(ioSlot) << "[Comp]:" << countIOBurst)
+        jobs[ioSlot].state = Process::State::READY;
+        readyQ.push(priorityOf(ioSlot));
+        isIOIdle = true;
+      } else {
+        LOG("\t", "IO", JOB(ioSlot) << ":" << countIOBurst)
+      }
+    }
+
+    if (isIOIdle && !ioQ.empty()) {
+      ioSlot = ioQ.front();
+      ioQ.pop();
+      countIOBurst = 0;
+      isIOIdle = false;
+      LOG("\t", "IO", JOB(ioSlot) << "[Sched]:" << countIOBurst)
+    }
+  }
+
+  void debug(Report& report) {
+    std::ostream nowhere(nullptr);
+    std::ostream& text = out ? *out : nowhere;
+    size_t missed = 0, completed = 0;
+    for (auto& task : tasks) {
+      if (out && logProcs) {
+        LOG_DEBUG(task.taskName, "Period:\t", task.period)
+        LOG_DEBUG("", "Deadline:\t", task.deadline)
+        LOG_DEBUG("", "Utilization:\t", task.utilization())
+        LOG_DEBUG("", "Jobs:\t\t", task.completed)
+        LOG_DEBUG("", "Deadline Misses:", task.missed)
+        if (task.completed) {
+          LOG_DEBUG("", "Avg Lateness:\t",
+                    (double)task.sumLateness / task.completed)
+          LOG_DEBUG("", "Max Lateness:\t", task.maxLateness)
+        }
+        *out << "\n";
+      }
+      report.addMetric(task.taskName + ".deadlineMisses", task.missed);
+      if (task.completed) {
+        report.addMetric(task.taskName + ".maxLateness", task.maxLateness);
+      }
+      missed += task.missed;
+      completed += task.completed;
+    }
+    text << "Horizon: " << horizon << "\n";
+    text << "Deadline Misses: " << missed << "/" << completed << "\n";
+    text << "Lateness p50/p90/p99/max: " << latenessPercentile(50) << "/"
+         << latenessPercentile(90) << "/" << latenessPercentile(99) << "/"
+         << latenessPercentile(100) << "\n";
+    report.addMetric("horizon", horizon);
+    report.addMetric("jobs", completed);
+    report.addMetric("deadlineMisses", missed);
+    report.addMetric("latenessP50", latenessPercentile(50));
+    report.addMetric("latenessP90", latenessPercentile(90));
+    report.addMetric("latenessP99", latenessPercentile(99));
+    report.addMetric("latenessMax", latenessPercentile(100));
+    report.addMetric("schedulable",
+                     policy->schedulability(tasks, text, report));
+  }
+
+  int64_t latenessPercentile(size_t pct) {
+    if (lateness.empty()) {
+      return 0;
+    }
+    // Nearest rank: the ceil(n * pct / 100)-th smallest, counting from 1
+    size_t rank = (lateness.size() * pct + 99) / 100;
+    rank = rank > 0 ? rank - 1 : 0;
+    std::nth_element(lateness.begin(), lateness.begin() + rank, lateness.end());
+    return lateness[rank];
+  }
+
+ private:
+  const Policy* policy = nullptr;
+  Tasks tasks = {};
+  Processes jobs = {};
+  std::vector<size_t> freeSlots;
+  std::vector<int64_t> lateness;
+  size_t liveJobs = 0;
+  size_t horizon = 0;
+  bool logProcs = true;
+  std::ostream* trace = nullptr;
+  std::ostream* out = nullptr;
+  size_t ticksCPU = 0;
+  bool isCPUIdle = true;
+  size_t execSlot = 0;
+
+  size_t countIOBurst = 0;
+  bool isIOIdle = true;
+  size_t ioSlot = 0;
+
+  // (release time, task) of every task's next job.
+  std::priority_queue<std::pair<size_t, size_t>,
+                      std::vector<std::pair<size_t, size_t>>,
+                      std::greater<std::pair<size_t, size_t>>>
+      releaseQ;
+  std::priority_queue<Priority, std::vector<Priority>, std::greater<Priority>>
+      readyQ;
+  std::queue<size_t> ioQ;
+
+  Priority priorityOf(size_t slot) {
+    return policy->priorityOf(tasks, jobs[slot], slot);
+  }
+
+  void retire(size_t slot) {
+    Process& job = jobs[slot];
+    Task& task = tasks[job.task];
+    int64_t late = job.lateness();
+    task.completed++;
+    task.missed += late > 0;
+    task.sumLateness += late;
+    task.maxLateness = std::max(task.maxLateness, late);
+    lateness.push_back(late);
+    freeSlots.push_back(slot);
+    liveJobs--;
+  }
+
+  void FreshArrivals() {
+    while (!releaseQ.empty() && releaseQ.top().first <= ticksCPU) {
+      size_t release = releaseQ.top().first, t = releaseQ.top().second;
+      releaseQ.pop();
+      size_t slot = jobs.size();
+      if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        jobs[slot] = Process(t, tasks[t].released++, release, tasks[t]);
+      } else {
+        jobs.push_back(Process(t, tasks[t].released++, release, tasks[t]));
+      }
+      liveJobs++;
+      LOG("\t", "CPU", JOB(slot) << "[Arrive]")
+      readyQ.push(priorityOf(slot));
+      if (release + tasks[t].period < horizon) {
+        releaseQ.push({release + tasks[t].period, t});
+      }
+    }
+  }
+};
+
+// Function to build periodic tasks from trace entries, as in
+// T0;0;2;1;5;10;8 (the deadline defaults to the period)
+Tasks toTasks(TraceEntries& entries) {
+  Tasks tasks;
+  for (auto& entry : entries) {
+    auto& f = entry.fields;
+    size_t deadline = f.size() > 5 ? f[5] : f[4];
+    tasks.push_back(
+        Task(std::move(entry.name), f[0], f[1], f[2], f[3], f[4], deadline));
+  }
+  return tasks;
+}
+
+}  // namespace
+
+int run(const Policy& policy, const SchedOptions& opts, Report& report) {
+  if (opts.cpus != 1 || opts.ios != 1) {
+    std::cerr << policy.name << ": only one CPU and one IO device are modelled"
+              << std::endl;
+    return 1;
+  }
+
+  // Read periodic tasks from input file
+  TraceEntries entries;
+  if (!readTrace(opts.trace, 5, SIZE_MAX, entries)) {
+    return 1;
+  }
+  Tasks tasks = toTasks(entries);
+
+  // Check if tasks were successfully read
+  if (tasks.empty()) {
+    std::cerr << "No tasks were read from " << opts.trace << std::endl;
+    return 1;
+  }
+
+  Device d;
+  d.init(policy, tasks, opts, report);
+  d.processor();
+  d.debug(report);
+
+  return 0;
+}
+
+}  // namespace periodic
@@ -0,0 +1,121 @@
+#ifndef PERIODIC_H
+#define PERIODIC_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "policies.h"
+
+// Periodic real-time tasks and the device that releases and runs their
+// jobs. edf.cpp and rm.cpp each supply only a Policy: the order ready jobs
+// run in, and the analytic schedulability test.
+
+namespace periodic {
+
+typedef struct Task {
+  std::string taskName;
+  size_t phase = 0;  // release time of the first job
+  size_t burstTimeCPU = SIZE_MAX;
+  size_t burstTimeIO = SIZE_MAX;
+  size_t burstTimeRate = SIZE_MAX;  // IO burst after every n CPU bursts
+  size_t period = SIZE_MAX;
+  size_t deadline = SIZE_MAX;  // relative to each release
+  size_t released = 0;
+  size_t completed = 0;
+  size_t missed = 0;
+  int64_t sumLateness = 0;
+  int64_t maxLateness = INT64_MIN;
+
+  Task() {}
+  Task(std::string&& name,
+       size_t ph,
+       size_t btCPU,
+       size_t btIO,
+       size_t btr,
+       size_t per,
+       size_t dl) {
+    taskName = std::move(name);
+    phase = ph;
+    burstTimeCPU = btCPU;
+    burstTimeIO = btIO;
+    burstTimeRate = btr;
+    period = std::max<size_t>(per, 1);
+    deadline = dl;
+  }
+  double utilization() const { return (double)burstTimeCPU / period; }
+  double density() const {
+    return (double)burstTimeCPU / std::max<size_t>(1, std::min(deadline, period));
+  }
+} Task;
+typedef std::vector<Task> Tasks;
+
+// One job of a periodic task; lives in the device's job pool from its
+// release until it completes.
+typedef struct Process {
+  enum State { READY, RUNNING, BLOCKED, TERMINATED };
+  size_t task = 0;
+  size_t jobNo = 0;
+  size_t arrivalTime = SIZE_MAX;
+  size_t absDeadline = SIZE_MAX;
+  size_t burstTimeCPU = SIZE_MAX;
+  size_t burstTimeIO = SIZE_MAX;
+  size_t burstTimeRate = SIZE_MAX;
+  size_t startTime = SIZE_MAX;
+  size_t completionTime;
+  size_t burstRemainCPU = SIZE_MAX;
+  size_t lastIOBurst = 0;
+  State state;
+
+  Process() {}
+  Process(size_t tsk, size_t no, size_t release, const Task& t) {
+    task = tsk;
+    jobNo = no;
+    arrivalTime = release;
+    absDeadline = release + t.deadline;
+    burstTimeCPU = t.burstTimeCPU;
+    burstRemainCPU = t.burstTimeCPU;
+    burstTimeIO = t.burstTimeIO;
+    burstTimeRate = t.burstTimeRate;
+    state = State::READY;
+  }
+  State exec() {
+    state = State::RUNNING;
+    if (--burstRemainCPU <= 0) {
+      state = State::TERMINATED;
+    } else if (++lastIOBurst >= burstTimeRate) {
+      refreshIOBurst();
+      state = State::BLOCKED;
+    }
+    return state;
+  }
+  void refreshIOBurst() { lastIOBurst = 0; }
+  int64_t lateness() { return (int64_t)completionTime - (int64_t)absDeadline; }
+} Process;
+typedef std::vector<Process> Processes;
+
+// Ready jobs run smallest key first. The last element is the job's slot.
+typedef std::tuple<size_t, size_t, size_t, size_t> Priority;
+
+typedef struct Policy {
+  const char* name;  // for error messages
+  Priority (*priorityOf)(const Tasks& tasks, const Process& job, size_t slot);
+  // Writes the verdict to `text` and `report`; true if schedulable. The
+  // verdict weighs CPU demand alone: IO blocking is not modelled, so a "yes"
+  // with observed misses points at IO contention.
+  bool (*schedulability)(const Tasks& tasks, std::ostream& text,
+                         Report& report);
+} Policy;
+
+// Reads periodic tasks from opts.trace and runs them under `policy`.
+// Returns 0 on success, or prints why to stderr and returns 1.
+int run(const Policy& policy, const SchedOptions& opts, Report& report);
+
+}  // namespace periodic
+
+#endif
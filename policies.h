@@ -0,0 +1,118 @@
+#ifndef POLICIES_H
+#define POLICIES_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Shared between the drivers (sched.cpp, difftest.cpp), the C++ policies and
+// the C ones:
+// run options, and the per-process record every policy reports back.
+
+enum SchedFormat { FORMAT_TEXT, FORMAT_JSON, FORMAT_CSV };
+enum SchedLogLevel { LOG_RESULTS, LOG_PROCESS, LOG_TRACE };
+
+struct SchedOptions {
+  const char* trace;  // input file
+  size_t timeQuantum;
+  size_t cpus;
+  size_t ios;
+  enum SchedFormat format;
+  enum SchedLogLevel logLevel;
+};
+
+struct SchedProc {
+  char name[32];
+  long arrivalTime;
+  long burstTime;
+  long startTime;
+  long completionTime;
+  long turnaroundTime;
+  long waitingTime;
+  long responseTime;
+};
+
+// What a C policy writes to: `trace` gets the per-tick log (NULL unless
+// logging at LOG_TRACE), `out` the text results (NULL unless FORMAT_TEXT).
+struct SchedReport {
+  FILE* trace;
+  FILE* out;
+  void* ctx;
+  void (*addProcess)(void* ctx, const struct SchedProc* proc);
+  void (*addMetric)(void* ctx, const char* name, double value);
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+int sjf(const struct SchedOptions* opts, struct SchedReport* report);
+int srtf(const struct SchedOptions* opts, struct SchedReport* report);
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define LOG_TICK(ticks) \
+  if (trace) *trace << ticks;
+#define LOG(tick, device, procData) \
+  if (trace) *trace << tick << "\t" << device << "\t\t" << procData << "\n";
+#define LOG_DEBUG(name, label, info) \
+  *out << name << "\n\t\t" << label "\t" << info;
+
+// What a C++ policy writes to; same contract as SchedReport.
+struct Report {
+  std::ostream* trace = nullptr;
+  std::ostream* out = nullptr;
+  std::vector<SchedProc> procs;
+  std::vector<std::pair<std::string, double>> metrics;
+
+  void addProcess(const std::string& name,
+                  long arrival,
+                  long burst,
+                  long start,
+                  long completion,
+                  long waiting) {
+    SchedProc proc = {};
+    name.copy(proc.name, sizeof(proc.name) - 1);
+    proc.arrivalTime = arrival;
+    proc.burstTime = burst;
+    proc.startTime = start;
+    proc.completionTime = completion;
+    proc.turnaroundTime = completion - arrival;
+    proc.waitingTime = waiting;
+    proc.responseTime = start - arrival;
+    procs.push_back(proc);
+  }
+  void addMetric(const std::string& name, double value) {
+    metrics.push_back({name, value});
+  }
+};
+
+// Each returns 0 on success, or prints why to stderr and returns 1.
+int rr(const SchedOptions& opts, Report& report);
+int vrr(const SchedOptions& opts, Report& report);
+int lottery(const SchedOptions& opts, Report& report);
+int stride(const SchedOptions& opts, Report& report);
+int edf(const SchedOptions& opts, Report& report);
+int rm(const SchedOptions& opts, Report& report);
+// Round robin over many traces at once on the SIMD batch engine.
+int batchRR(const SchedOptions& opts,
+            const std::vector<std::string>& traces,
+            std::vector<Report>& reports);
+// Times `count` random traces on the batch engine against rr running them
+// one at a time.
+int batchBench(const SchedOptions& opts, size_t count);
+// Times rr on random traces of `count` processes, with the hot/cold split
+// record layout and with the flat one it replaced.
+int rrBench(const SchedOptions& opts, size_t count);
+// Seconds rr's engine takes to run each trace (in trace file format) in
+// turn, not counting parsing; the baseline batchBench compares against.
+// Negative if a trace does not parse.
+double rrTime(const SchedOptions& opts, const std::vector<std::string>& traces);
+#endif
+
+#endif
@@ -1,24 +1,35 @@
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <ostream>
 #include <queue>
+#include <random>
 #include <string>
 #include <utility>
 #include <vector>
-#include <fstream>
 #include <sstream>
 
-#define LOG_TICK(ticks) std::cout << ticks;
-#define LOG(tick, device, procData) \
-  std::cout << tick << "\t" << device << "\t\t" << procData << "\n";
-#define LOG_DEBUG(name, label, info) \
-  std::cout << name << "\n\t\t" << label "\t" << info;
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
+#include "counters.h"
+#include "policies.h"
+#include "trace.h"
+
+namespace {
+
+const uint32_t noSlot = UINT32_MAX;
+
+// What a process is: its trace entry and results. The tick loop reads it
+// only at arrival, first dispatch and completion, and when logging.
 typedef struct Process {
-  enum State { READY, RUNNING, BLOCKED, TERMINATED };
   std::string procName;
   size_t arrivalTime = SIZE_MAX;
   size_t burstTimeCPU = SIZE_MAX;
@@ -26,9 +37,6 @@ typedef struct Process {
   size_t burstTimeRate = SIZE_MAX;  // IO burst after every n CPU bursts
   size_t startTime = SIZE_MAX;
   size_t completionTime;
-  size_t burstRemainCPU = SIZE_MAX;
-  size_t lastIOBurst = 0;
-  State state;
 
   Process() {}
   Process(std::string&& name,
@@ -39,10 +47,37 @@ typedef struct Process {
     procName = std::move(name);
     arrivalTime = at;
     burstTimeCPU = btCPU;
-    burstRemainCPU = btCPU;
     burstTimeIO = btIO;
     burstTimeRate = btr;
   }
+  size_t turnAroundTime() { return completionTime - arrivalTime; }
+  size_t waitingTime() { return turnAroundTime() - burstTimeCPU; }
+  size_t responseTime() { return startTime - arrivalTime; }
+} Process;
+typedef std::vector<Process> Processes;
+
+// What the tick loop works on, two to a cache line. Burst lengths are held
+// in 32 bits; longer ones saturate.
+typedef struct alignas(32) HotProcess {
+  enum State : uint8_t { READY, RUNNING, BLOCKED, TERMINATED };
+  uint32_t burstRemainCPU;
+  uint32_t lastIOBurst;
+  uint32_t burstTimeRate;
+  uint32_t burstTimeIO;
+  uint32_t proc;  // index into Device::procs, or the next free slot
+  State state;
+  bool started;
+
+  void init(const Process& info, uint32_t index) {
+    // The trace reader rejects values above UINT32_MAX
+    burstRemainCPU = (uint32_t)info.burstTimeCPU;
+    lastIOBurst = 0;
+    burstTimeRate = (uint32_t)info.burstTimeRate;
+    burstTimeIO = (uint32_t)info.burstTimeIO;
+    proc = index;
+    state = READY;
+    started = false;
+  }
   State exec() {
     state = State::RUNNING;
     if (--burstRemainCPU <= 0) {
@@ -54,201 +89,501 @@ typedef struct Process {
     return state;
   }
   void refreshIOBurst() { lastIOBurst = 0; }
-  size_t turnAroundTime() { return completionTime - arrivalTime; }
-  size_t waitingTime() { return turnAroundTime() - burstTimeCPU; }
-  size_t responseTime() { return startTime - arrivalTime; }
-} Process;
-typedef std::vector<Process> Processes;
+} HotProcess;
+
+// Hot records in 64-byte-aligned chunks, addressed by slot. A finished
+// process's slot goes on a free list for the next arrival, so the records
+// in use stay as few as the processes alive at once.
+class ProcessPool {
+ public:
+  uint32_t alloc() {
+    if (freeSlot != noSlot) {
+      uint32_t slot = freeSlot;
+      freeSlot = (*this)[slot].proc;
+      return slot;
+    }
+    if (used % chunkSize == 0) {
+      chunks.emplace_back(new Chunk);
+    }
+    return used++;
+  }
+  void release(uint32_t slot) {
+    (*this)[slot].proc = freeSlot;
+    freeSlot = slot;
+  }
+  HotProcess& operator[](uint32_t slot) {
+    return chunks[slot / chunkSize]->procs[slot % chunkSize];
+  }
+  size_t slots() const { return used; }
+
+ private:
+  static const uint32_t chunkSize = 256;
+  typedef struct alignas(64) Chunk {
+    HotProcess procs[chunkSize];
+  } Chunk;
+  std::vector<std::unique_ptr<Chunk>> chunks;
+  uint32_t used = 0;
+  uint32_t freeSlot = noSlot;
+};
+
+// Where a Device keeps the records of live processes. Queues and devices
+// hold Handles; hot() and info() reach the two halves of a record.
+
+// The layout rr runs with: hot records in the pool, addressed by slot, and
+// cold records left in Device::procs.
+class SplitStore {
+ public:
+  typedef uint32_t Handle;
+  static const size_t recordBytes = sizeof(HotProcess);
 
+  Handle admit(Processes& procs, uint32_t index) {
+    uint32_t slot = pool.alloc();
+    pool[slot].init(procs[index], index);
+    return slot;
+  }
+  HotProcess& hot(Handle slot) { return pool[slot]; }
+  Process& info(Processes& procs, Handle slot) {
+    return procs[pool[slot].proc];
+  }
+  void retire(Processes&, Handle slot) { pool.release(slot); }
+  size_t peakRecords() const { return pool.slots(); }
+
+ private:
+  ProcessPool pool;
+};
+
+// The layout before the hot/cold split, kept to benchmark against: the
+// whole record, name included, travels by value through the queues and
+// devices, and is written back to Device::procs on completion.
+class FlatStore {
+ public:
+  typedef struct FlatProcess {
+    HotProcess hot;
+    Process info;
+  } Handle;
+  static const size_t recordBytes = sizeof(FlatProcess);
+
+  Handle admit(Processes& procs, uint32_t index) {
+    Handle proc;
+    proc.info = procs[index];
+    proc.hot.init(proc.info, index);
+    peak = std::max(peak, ++live);
+    return proc;
+  }
+  HotProcess& hot(Handle& proc) { return proc.hot; }
+  Process& info(Processes&, Handle& proc) { return proc.info; }
+  void retire(Processes& procs, Handle& proc) {
+    procs[proc.hot.proc] = proc.info;
+    live--;
+  }
+  size_t peakRecords() const { return peak; }
+
+ private:
+  size_t live = 0;
+  size_t peak = 0;
+};
+
+template <class Handle>
+struct CPU {
+  std::string deviceName;
+  Handle exec = {};
+  size_t q = 0;
+  bool isCPUIdle = true;
+};
+
+template <class Handle>
+struct IO {
+  std::string deviceName;
+  Handle exec = {};
+  size_t countIOBurst = 0;
+  bool isIOIdle = true;
+};
+
+template <class Store>
 class Device {
  public:
+  typedef typename Store::Handle Handle;
+
   Device() {}
-  void init(Processes& procs) {
+  void init(Processes& procs, const SchedOptions& opts, Report& report) {
     this->procs = procs;
+    std::stable_sort(this->procs.begin(), this->procs.end(),
+                     [](const Process& a, const Process& b) {
+                       return a.arrivalTime < b.arrivalTime;
+                     });
     totalProc = procs.size();
+    timeQuantum = opts.timeQuantum;
+    logProcs = opts.logLevel >= LOG_PROCESS;
+    trace = report.trace;
+    out = report.out;
+    cpus.resize(opts.cpus);
+    for (size_t i = 0; i < cpus.size(); i++) {
+      cpus[i].deviceName = cpus.size() > 1 ? "CPU" + std::to_string(i) : "CPU";
+    }
+    ios.resize(opts.ios);
+    for (size_t i = 0; i < ios.size(); i++) {
+      ios[i].deviceName = ios.size() > 1 ? "IO" + std::to_string(i) : "IO";
+    }
   }
 
   void processor() {
-    Process execProc;
-    size_t q = 0;
     LOG("Time (tick)", "Device", "Process Served")
     while (totalProc) {
       LOG_TICK(ticksCPU)
-      if (isCPUIdle) {
-        LOG("\t", "CPU", "-");
+      COUNT(ticks);
+      for (auto& cpu : cpus) {
+        if (cpu.isCPUIdle) {
+          LOG("\t", cpu.deviceName, "-");
+          COUNT(idleTicks);
+          COUNT_IF(ioStalls, waitingOnIO());
+        }
       }
+      TIME_BEGIN(PHASE_ARRIVAL)
       FreshArrivals();
+      TIME_END(PHASE_ARRIVAL)
 
-      if (!isCPUIdle) {
-        execProc.exec();
-        if (execProc.state == Process::State::TERMINATED) {
-          LOG("\t", "CPU", execProc.procName << "[Comp]");
-          isCPUIdle = true;
-          totalProc--;
-          execProc.completionTime = ticksCPU;
-          completedProcs.push_back(execProc);
-          execProc = {};
-        } else if (execProc.state == Process::State::BLOCKED) {
-          LOG("\t", "CPU",
-              execProc.procName << "[Q IO]:" << execProc.burstRemainCPU);
-          ioQ.push(execProc);
-          isCPUIdle = true;
-          execProc = {};
-        } else {
-          LOG("\t", "CPU", execProc.procName << ":" << execProc.burstRemainCPU)
-        }
+      TIME_BEGIN(PHASE_DISPATCH)
+      for (auto& cpu : cpus) {
+        execute(cpu);
+      }
+      for (auto& cpu : cpus) {
+        schedule(cpu);
+      }
+      TIME_END(PHASE_DISPATCH)
+      TIME_BEGIN(PHASE_IO)
+      for (auto& io : ios) {
+        ioDevice(io);
+      }
+      TIME_END(PHASE_IO)
+      ticksCPU++;
+      for (auto& cpu : cpus) {
+        cpu.q++;
+      }
+      if (trace) {
+        *trace << "\n";
       }
+    }
+  }
 
-      bool toSchedule = !readyQ.empty() && (isCPUIdle || q + 1 >= timeQuantum);
-      if (toSchedule) {
-        auto proc = readyQ.front();
-        readyQ.pop();
-        if (!isCPUIdle) {
-          readyQ.push(execProc);
-        }
-        if (q + 1 >= timeQuantum && !isCPUIdle) {
-          LOG("\t", "CPU", execProc.procName << "[Preempt]->" << proc.procName)
-        } else {
-          LOG("\t", "CPU", proc.procName << "[Sched]")
-        }
-        execProc = proc;
-        execProc.startTime = std::min(execProc.startTime, ticksCPU);
-        isCPUIdle = false;
-        q = -1;
+  void execute(CPU<Handle>& cpu) {
+    if (!cpu.isCPUIdle) {
+      HotProcess& execProc = store.hot(cpu.exec);
+      execProc.exec();
+      if (execProc.state == HotProcess::State::TERMINATED) {
+        LOG("\t", cpu.deviceName, nameOf(cpu.exec) << "[Comp]");
+        cpu.isCPUIdle = true;
+        totalProc--;
+        store.info(procs, cpu.exec).completionTime = ticksCPU;
+        completedProcs.push_back(execProc.proc);
+        store.retire(procs, cpu.exec);
+      } else if (execProc.state == HotProcess::State::BLOCKED) {
+        LOG("\t", cpu.deviceName,
+            nameOf(cpu.exec) << "[Q IO]:" << execProc.burstRemainCPU);
+        ioQ.push(cpu.exec);
+        COUNT_PUSH(QUEUE_IO, ioQ.size());
+        cpu.isCPUIdle = true;
+      } else {
+        LOG("\t", cpu.deviceName,
+            nameOf(cpu.exec) << ":" << execProc.burstRemainCPU)
       }
+    }
+  }
 
-      ioDevice();
-      ticksCPU++;
-      q++;
-      std::cout << "\n";
+  void schedule(CPU<Handle>& cpu) {
+    bool toSchedule =
+        !readyQ.empty() && (cpu.isCPUIdle || cpu.q + 1 >= timeQuantum);
+    if (toSchedule) {
+      Handle next = readyQ.front();
+      readyQ.pop();
+      COUNT_POP(QUEUE_READY);
+      COUNT(contextSwitches);
+      if (!cpu.isCPUIdle) {
+        readyQ.push(cpu.exec);
+        COUNT_PUSH(QUEUE_READY, readyQ.size());
+        COUNT(preemptions);
+      }
+      if (cpu.q + 1 >= timeQuantum && !cpu.isCPUIdle) {
+        LOG("\t", cpu.deviceName,
+            nameOf(cpu.exec) << "[Preempt]->" << nameOf(next))
+      } else {
+        LOG("\t", cpu.deviceName, nameOf(next) << "[Sched]")
+      }
+      cpu.exec = next;
+      HotProcess& execProc = store.hot(cpu.exec);
+      if (!execProc.started) {
+        execProc.started = true;
+        store.info(procs, cpu.exec).startTime = ticksCPU;
+      }
+      cpu.isCPUIdle = false;
+      cpu.q = -1;
     }
   }
 
-  void ioDevice() {
-    if (!isIOIdle) {
-      if (++countIOBurst >= execProcIO.burstTimeIO) {
-        LOG("\t", "IO", execProcIO.procName << "[Comp]:" << countIOBurst)
-        readyQ.push(execProcIO);
-        execProcIO = {};
-        isIOIdle = true;
+  void ioDevice(IO<Handle>& io) {
+    if (!io.isIOIdle) {
+      if (++io.countIOBurst >= store.hot(io.exec).burstTimeIO) {
+        LOG("\t", io.deviceName,
+            nameOf(io.exec) << "[Comp]:" << io.countIOBurst)
+        readyQ.push(io.exec);
+        COUNT_PUSH(QUEUE_READY, readyQ.size());
+        io.isIOIdle = true;
       } else {
-        LOG("\t", "IO", execProcIO.procName << ":" << countIOBurst)
+        LOG("\t", io.deviceName, nameOf(io.exec) << ":" << io.countIOBurst)
       }
     }
 
-    if (isIOIdle && !ioQ.empty()) {
-      execProcIO = ioQ.front();
+    if (io.isIOIdle && !ioQ.empty()) {
+      io.exec = ioQ.front();
       ioQ.pop();
-      countIOBurst = 0;
-      isIOIdle = false;
-      LOG("\t", "IO", execProcIO.procName << "[Sched]:" << countIOBurst)
+      COUNT_POP(QUEUE_IO);
+      io.countIOBurst = 0;
+      io.isIOIdle = false;
+      LOG("\t", io.deviceName,
+          nameOf(io.exec) << "[Sched]:" << io.countIOBurst)
     }
   }
 
-  void debug() {
-    for (auto& proc : completedProcs) {
-      LOG_DEBUG(proc.procName, "Arrival Time:\t", proc.arrivalTime)
-      LOG_DEBUG("", "Start Time:\t", proc.startTime)
-      LOG_DEBUG("", "Response Time:\t", proc.responseTime())
-      LOG_DEBUG("", "Completion Time:", proc.completionTime)
-      LOG_DEBUG("", "Turnaround Time:", proc.turnAroundTime())
-      LOG_DEBUG("", "Waiting Time:\t", proc.waitingTime() << "\n")
+  void debug(Report& report) {
+    for (auto index : completedProcs) {
+      Process& proc = procs[index];
+      if (out && logProcs) {
+        LOG_DEBUG(proc.procName, "Arrival Time:\t", proc.arrivalTime)
+        LOG_DEBUG("", "Start Time:\t", proc.startTime)
+        LOG_DEBUG("", "Response Time:\t", proc.responseTime())
+        LOG_DEBUG("", "Completion Time:", proc.completionTime)
+        LOG_DEBUG("", "Turnaround Time:", proc.turnAroundTime())
+        LOG_DEBUG("", "Waiting Time:\t", proc.waitingTime() << "\n")
+      }
+      report.addProcess(proc.procName, proc.arrivalTime, proc.burstTimeCPU,
+                        proc.startTime, proc.completionTime,
+                        proc.waitingTime());
+    }
+    report.addMetric("avgWaitingTime", avgWaitingTime());
+    if (out) {
+      *out << "Avg Waiting Time: " << avgWaitingTime();
     }
-    std::cout << "Avg Waiting Time: " << avgWaitingTime();
   }
 
   double avgWaitingTime() {
     double sum = 0;
-    for (auto& proc : completedProcs) {
-      sum += proc.waitingTime();
+    for (auto index : completedProcs) {
+      sum += procs[index].waitingTime();
     }
     return (double)(sum / completedProcs.size());
   }
 
+  size_t ticks() const { return ticksCPU; }
+  size_t peakRecords() const { return store.peakRecords(); }
+
  private:
-  Processes completedProcs = {};
-  Processes procs = {};
+  std::vector<uint32_t> completedProcs = {};  // indices into procs
+  Processes procs = {};  // in arrival order
+  size_t nextArrival = 0;
   size_t totalProc = 0;
   size_t ticksCPU = 0;
   size_t timeQuantum = 5;
-  bool isCPUIdle = true;
+  bool logProcs = true;
+  std::ostream* trace = nullptr;
+  std::ostream* out = nullptr;
 
-  size_t countIOBurst = 0;
-  bool isIOIdle = true;
-  Process execProcIO;
+  std::vector<CPU<Handle>> cpus;
+  std::vector<IO<Handle>> ios;
 
-  std::queue<Process> readyQ;
-  std::queue<Process> ioQ;
+  Store store;
+  std::queue<Handle> readyQ;
+  std::queue<Handle> ioQ;
 
-  void FreshArrivals() {
-    int index = 0;
-    for (auto& proc : procs) {
-      if (proc.arrivalTime == ticksCPU) {
-        LOG("\t", "CPU", proc.procName << "[Arrive]")
-        proc.state = Process::State::READY;
-        readyQ.push(proc);
-        procs.erase(procs.begin() + index);
-        continue;
+  const std::string& nameOf(Handle& proc) {
+    return store.info(procs, proc).procName;
+  }
+
+  bool waitingOnIO() {
+    if (!ioQ.empty()) {
+      return true;
+    }
+    for (auto& io : ios) {
+      if (!io.isIOIdle) {
+        return true;
       }
-      index++;
+    }
+    return false;
+  }
+
+  // Processes arriving on the same tick join readyQ in trace order.
+  void FreshArrivals() {
+    while (nextArrival < procs.size() &&
+           procs[nextArrival].arrivalTime <= ticksCPU) {
+      Process& proc = procs[nextArrival];
+      LOG("\t", "CPU", proc.procName << "[Arrive]")
+      readyQ.push(store.admit(procs, nextArrival));
+      COUNT_PUSH(QUEUE_READY, readyQ.size());
+      nextArrival++;
     }
   }
 };
 
-// Function to read processes from input file
-Processes readProcessesFromFile(const std::string& filename) {
+// Function to build processes from trace entries
+Processes toProcesses(TraceEntries& entries) {
   Processes processes;
-  std::ifstream inputFile(filename);
-  
-  if (!inputFile.is_open()) {
-    std::cerr << "Error: Unable to open file " << filename << std::endl;
-    return processes;
-  }
-  
-  std::string line;
-  while (std::getline(inputFile, line)) {
-    std::stringstream ss(line);
-    std::string procName;
-    size_t arrivalTime, burstTimeCPU, burstTimeIO, burstTimeRate;
-    
-    // Parse line with format: P0;0;24;2;5
-    std::getline(ss, procName, ';');
-    
-    std::string value;
-    std::getline(ss, value, ';');
-    arrivalTime = std::stoul(value);
-    
-    std::getline(ss, value, ';');
-    burstTimeCPU = std::stoul(value);
-    
-    std::getline(ss, value, ';');
-    burstTimeIO = std::stoul(value);
-    
-    std::getline(ss, value, ';');
-    burstTimeRate = std::stoul(value);
-    
-    // Create and add the process
-    processes.push_back(Process(std::move(procName), arrivalTime, burstTimeCPU, burstTimeIO, burstTimeRate));
-  }
-  
-  inputFile.close();
+  for (auto& entry : entries) {
+    auto& f = entry.fields;
+    processes.push_back(
+        Process(std::move(entry.name), f[0], f[1], f[2], f[3]));
+  }
   return processes;
 }
 
-int main() {
+// Bursts average about 30 CPU ticks. A spread trace has its arrivals over
+// [0, count), so late in the run nearly every process is alive at once. A
+// churn trace has them over [0, 32 * count), about as fast as one CPU
+// finishes them, so few are alive and finished records are reused.
+Processes randomProcesses(size_t count, bool churn, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  auto pick = [&rng](size_t lo, size_t hi) {
+    return std::uniform_int_distribution<size_t>(lo, hi)(rng);
+  };
+  size_t span = churn ? 32 * count : count;
+  Processes procs;
+  procs.reserve(count);
+  for (size_t p = 0; p < count; p++) {
+    procs.push_back(Process("P" + std::to_string(p), pick(0, span - 1),
+                            pick(1, 60), pick(0, 6), pick(1, 10)));
+  }
+  return procs;
+}
+
+// Counts cache misses on this thread while alive, where the kernel and the
+// hardware allow it.
+class CacheMisses {
+ public:
+  CacheMisses() {
+#ifdef __linux__
+    perf_event_attr attr = {};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+  ~CacheMisses() {
+#ifdef __linux__
+    if (fd >= 0) {
+      close(fd);
+    }
+#endif
+  }
+  // Misses so far, or -1 if they cannot be counted here.
+  long long read() const {
+    long long misses = -1;
+#ifdef __linux__
+    if (fd < 0 || ::read(fd, &misses, sizeof(misses)) != sizeof(misses)) {
+      return -1;
+    }
+#endif
+    return misses;
+  }
+
+ private:
+  int fd = -1;
+};
+
+// Runs `procs` to completion on one record layout, printing the time and
+// cache misses per tick. Returns the ticks taken.
+template <class Store>
+size_t benchLayout(const char* layout,
+                   Processes& procs,
+                   const SchedOptions& opts) {
+  Report report;
+  Device<Store> d;
+  d.init(procs, opts, report);
+  CacheMisses misses;
+  auto begin = std::chrono::steady_clock::now();
+  long long missesBegin = misses.read();
+  d.processor();
+  long long missesEnd = misses.read();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+
+  std::cout << "  " << layout << ": " << elapsed.count() << " s, "
+            << elapsed.count() * 1e9 / d.ticks() << " ns/tick, peak "
+            << d.peakRecords() << " live records of " << Store::recordBytes
+            << " bytes, cache misses: ";
+  if (missesBegin < 0 || missesEnd < 0) {
+    std::cout << "unavailable\n";
+  } else {
+    std::cout << missesEnd - missesBegin << " ("
+              << (double)(missesEnd - missesBegin) / d.ticks() << "/tick)\n";
+  }
+  return d.ticks();
+}
+
+}  // namespace
+
+int rr(const SchedOptions& opts, Report& report) {
   // Read processes from input file
-  Processes procs = readProcessesFromFile("input.txt");
-  
+  TraceEntries entries;
+  if (!readTrace(opts.trace, 4, UINT32_MAX, entries)) {
+    return 1;
+  }
+  Processes procs = toProcesses(entries);
+
   // Check if processes were successfully read
   if (procs.empty()) {
-    std::cerr << "No processes were read from the input file." << std::endl;
+    std::cerr << "No processes were read from " << opts.trace << std::endl;
     return 1;
   }
-  
-  Device d;
-  d.init(procs);
+
+  Device<SplitStore> d;
+  d.init(procs, opts, report);
   d.processor();
-  d.debug();
+  d.debug(report);
 
   return 0;
-}
\ No newline at end of file
+}
+
+double rrTime(const SchedOptions& opts, const std::vector<std::string>& traces) {
+  std::vector<Processes> parsed;
+  for (size_t t = 0; t < traces.size(); t++) {
+    std::istringstream input(traces[t]);
+    TraceEntries entries;
+    if (!readTrace(input, "trace " + std::to_string(t), 4, UINT32_MAX,
+                   entries)) {
+      return -1;
+    }
+    parsed.push_back(toProcesses(entries));
+  }
+  SchedOptions timeOpts = opts;
+  timeOpts.logLevel = LOG_RESULTS;
+
+  auto begin = std::chrono::steady_clock::now();
+  for (auto& procs : parsed) {
+    Report report;
+    Device<SplitStore> d;
+    d.init(procs, timeOpts, report);
+    d.processor();
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - begin;
+  return elapsed.count();
+}
+
+int rrBench(const SchedOptions& opts, size_t count) {
+  SchedOptions benchOpts = opts;
+  benchOpts.logLevel = LOG_RESULTS;
+  for (bool churn : {false, true}) {
+    Processes procs = randomProcesses(count, churn, 1);
+    std::cout << (churn ? "Churn" : "Spread") << " trace, " << count
+              << " processes:\n";
+    size_t flatTicks = benchLayout<FlatStore>("flat ", procs, benchOpts);
+    size_t splitTicks = benchLayout<SplitStore>("split", procs, benchOpts);
+    if (flatTicks != splitTicks) {
+      std::cerr << "rr: layouts disagree, " << flatTicks << " ticks against "
+                << splitTicks << std::endl;
+      return 1;
+    }
+    std::cout << "  ticks: " << splitTicks << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,392 @@
+// Command-line driver for every policy in this directory.
+//
+// Build:
+//   gcc -O2 -c sjf.c srtf.c counters.c
+//   g++ -std=c++17 -O2 -march=native -pthread -o sched sched.cpp rr.cpp
+//       vrr.cpp lottery.cpp stride.cpp share.cpp edf.cpp rm.cpp periodic.cpp
+//       batch_rr.cpp trace.cpp sjf.o srtf.o counters.o
+//
+// Add -DSCHED_COUNTERS (or -DSCHED_TIMERS) to every compile to get the
+// hot-path counters of counters.h, written to stderr as JSON at exit. The
+// batch engine (-b) is not instrumented and writes none.
+//
+// Example:
+//   ./sched -p rr -q 5 -f json -l results -j 4 input.txt processes.txt
+
+#include <getopt.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "counters.h"
+#include "policies.h"
+
+namespace {
+
+typedef int (*Policy)(const SchedOptions& opts, Report& report);
+
+// Runs one of the C policies, collecting its FILE* output and callbacks into
+// the same Report the C++ policies fill in.
+template <int (*policy)(const SchedOptions*, SchedReport*)>
+int runC(const SchedOptions& opts, Report& report) {
+  char* traceBuf = nullptr;
+  char* outBuf = nullptr;
+  size_t traceLen = 0, outLen = 0;
+  SchedReport cReport = {};
+  cReport.trace = report.trace ? open_memstream(&traceBuf, &traceLen) : nullptr;
+  cReport.out = report.out ? open_memstream(&outBuf, &outLen) : nullptr;
+  cReport.ctx = &report;
+  cReport.addProcess = [](void* ctx, const SchedProc* proc) {
+    static_cast<Report*>(ctx)->procs.push_back(*proc);
+  };
+  cReport.addMetric = [](void* ctx, const char* name, double value) {
+    static_cast<Report*>(ctx)->addMetric(name, value);
+  };
+
+  int status = policy(&opts, &cReport);
+
+  if (cReport.trace) {
+    fclose(cReport.trace);
+    report.trace->write(traceBuf, traceLen);
+    free(traceBuf);
+  }
+  if (cReport.out) {
+    fclose(cReport.out);
+    report.out->write(outBuf, outLen);
+    free(outBuf);
+  }
+  return status;
+}
+
+const std::map<std::string, Policy> policies = {
+    {"rr", rr},
+    {"vrr", vrr},
+    {"sjf", runC<sjf>},
+    {"srtf", runC<srtf>},
+    {"lottery", lottery},
+    {"stride", stride},
+    {"edf", edf},
+    {"rm", rm},
+};
+
+void usage(const char* argv0) {
+  std::cerr
+      << "Usage: " << argv0 << " [options] trace...\n"
+      << "  -p, --policy NAME    rr, vrr, sjf, srtf, lottery, stride, edf, rm"
+         " (default rr)\n"
+      << "  -q, --quantum N      time quantum in ticks (default 5)\n"
+      << "      --cpus N         number of CPUs (default 1)\n"
+      << "      --ios N          number of IO devices (default 1)\n"
+      << "  -f, --format FMT     text, json or csv (default text)\n"
+      << "  -l, --log LEVEL      results, process or trace (default trace for"
+         " text, results otherwise)\n"
+      << "  -j, --threads N      traces simulated in parallel (default 1)\n"
+      << "  -b, --batch          replay all traces on the SIMD engine (rr)\n"
+      << "      --bench N        with -b, time the SIMD engine on N random traces;\n"
+      << "                       with -p rr, time rr's record layouts on traces\n"
+      << "                       of N processes\n";
+}
+
+bool parseCount(const char* arg, size_t& value) {
+  char* end = nullptr;
+  long long n = strtoll(arg, &end, 10);
+  if (!*arg || *end || n < 1) {
+    return false;
+  }
+  value = n;
+  return true;
+}
+
+std::string jsonString(const std::string& s) {
+  std::string quoted = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+    }
+    if (static_cast<unsigned char>(c) < 0x20) {
+      continue;
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+std::string jsonNumber(double value) {
+  if (!std::isfinite(value)) {
+    return "null";
+  }
+  std::ostringstream s;
+  s << value;
+  return s.str();
+}
+
+void printJSON(const std::vector<std::string>& traces,
+               const std::string& policy,
+               const std::vector<Report>& reports) {
+  std::cout << "[";
+  for (size_t t = 0; t < traces.size(); t++) {
+    const Report& report = reports[t];
+    std::cout << (t ? ",\n " : "\n ") << "{\"trace\": " << jsonString(traces[t])
+              << ", \"policy\": " << jsonString(policy) << ",\n  \"metrics\": {";
+    for (size_t m = 0; m < report.metrics.size(); m++) {
+      std::cout << (m ? ", " : "") << jsonString(report.metrics[m].first) << ": "
+                << jsonNumber(report.metrics[m].second);
+    }
+    std::cout << "},\n  \"processes\": [";
+    for (size_t p = 0; p < report.procs.size(); p++) {
+      const SchedProc& proc = report.procs[p];
+      std::cout << (p ? ",\n    " : "\n    ") << "{\"name\": "
+                << jsonString(proc.name)
+                << ", \"arrivalTime\": " << proc.arrivalTime
+                << ", \"burstTime\": " << proc.burstTime
+                << ", \"startTime\": " << proc.startTime
+                << ", \"completionTime\": " << proc.completionTime
+                << ", \"turnaroundTime\": " << proc.turnaroundTime
+                << ", \"waitingTime\": " << proc.waitingTime
+                << ", \"responseTime\": " << proc.responseTime << "}";
+    }
+    std::cout << "]}";
+  }
+  std::cout << "\n]\n";
+}
+
+// Long form, one value per row, so every policy shares the same columns.
+void printCSV(const std::vector<std::string>& traces,
+              const std::string& policy,
+              const std::vector<Report>& reports) {
+  std::cout << "trace,policy,process,field,value\n";
+  for (size_t t = 0; t < traces.size(); t++) {
+    const Report& report = reports[t];
+    std::string prefix = traces[t] + "," + policy + ",";
+    for (auto& metric : report.metrics) {
+      std::cout << prefix << "," << metric.first << ","
+                << jsonNumber(metric.second) << "\n";
+    }
+    for (auto& proc : report.procs) {
+      std::pair<const char*, long> fields[] = {
+          {"arrivalTime", proc.arrivalTime},
+          {"burstTime", proc.burstTime},
+          {"startTime", proc.startTime},
+          {"completionTime", proc.completionTime},
+          {"turnaroundTime", proc.turnaroundTime},
+          {"waitingTime", proc.waitingTime},
+          {"responseTime", proc.responseTime},
+      };
+      for (auto& field : fields) {
+        std::cout << prefix << proc.name << "," << field.first << ","
+                  << field.second << "\n";
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  SchedOptions opts = {};
+  opts.timeQuantum = 5;
+  opts.cpus = 1;
+  opts.ios = 1;
+  opts.format = FORMAT_TEXT;
+  std::string policy = "rr";
+  std::string logLevel;
+  size_t threads = 1, benchCount = 0;
+  bool batch = false;
+
+  enum { OPT_CPUS = 256, OPT_IOS, OPT_BENCH };
+  const option longOptions[] = {
+      {"policy", required_argument, nullptr, 'p'},
+      {"quantum", required_argument, nullptr, 'q'},
+      {"cpus", required_argument, nullptr, OPT_CPUS},
+      {"ios", required_argument, nullptr, OPT_IOS},
+      {"format", required_argument, nullptr, 'f'},
+      {"log", required_argument, nullptr, 'l'},
+      {"threads", required_argument, nullptr, 'j'},
+      {"batch", no_argument, nullptr, 'b'},
+      {"bench", required_argument, nullptr, OPT_BENCH},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, 0, nullptr, 0},
+  };
+
+  int c;
+  while ((c = getopt_long(argc, argv, "p:q:f:l:j:bh", longOptions, nullptr)) !=
+         -1) {
+    bool ok = true;
+    switch (c) {
+      case 'p':
+        policy = optarg;
+        ok = policies.count(policy);
+        break;
+      case 'q':
+        ok = parseCount(optarg, opts.timeQuantum);
+        break;
+      case OPT_CPUS:
+        ok = parseCount(optarg, opts.cpus);
+        break;
+      case OPT_IOS:
+        ok = parseCount(optarg, opts.ios);
+        break;
+      case 'f':
+        if (std::string(optarg) == "text") {
+          opts.format = FORMAT_TEXT;
+        } else if (std::string(optarg) == "json") {
+          opts.format = FORMAT_JSON;
+        } else if (std::string(optarg) == "csv") {
+          opts.format = FORMAT_CSV;
+        } else {
+          ok = false;
+        }
+        break;
+      case 'l':
+        logLevel = optarg;
+        ok = logLevel == "results" || logLevel == "process" ||
+             logLevel == "trace";
+        break;
+      case 'j':
+        ok = parseCount(optarg, threads);
+        break;
+      case 'b':
+        batch = true;
+        break;
+      case OPT_BENCH:
+        ok = parseCount(optarg, benchCount);
+        break;
+      case 'h':
+        usage(argv[0]);
+        return 0;
+      default:
+        ok = false;
+    }
+    if (!ok) {
+      if (optarg && c != '?') {
+        std::cerr << argv[0] << ": invalid argument '" << optarg << "'\n";
+      }
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (logLevel.empty()) {
+    opts.logLevel = opts.format == FORMAT_TEXT ? LOG_TRACE : LOG_RESULTS;
+  } else {
+    opts.logLevel = logLevel == "trace"     ? LOG_TRACE
+                    : logLevel == "process" ? LOG_PROCESS
+                                            : LOG_RESULTS;
+  }
+
+  if (benchCount) {
+    if (batch) {
+      return batchBench(opts, benchCount);
+    }
+    if (policy == "rr") {
+      return rrBench(opts, benchCount);
+    }
+    std::cerr << argv[0] << ": --bench is only available for rr\n";
+    return 2;
+  }
+
+  std::vector<std::string> traces(argv + optind, argv + argc);
+  if (traces.empty()) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (batch && policy != "rr") {
+    std::cerr << argv[0] << ": --batch is only available for rr\n";
+    return 2;
+  }
+
+  // Text output keeps the tick log and the results in one stream, as the
+  // policies print them; structured output sends the tick log to stderr.
+  std::vector<std::ostringstream> logs(traces.size());
+  std::vector<Report> reports(traces.size());
+  for (size_t t = 0; t < traces.size(); t++) {
+    if (opts.logLevel == LOG_TRACE) {
+      reports[t].trace = &logs[t];
+    }
+    if (opts.format == FORMAT_TEXT) {
+      reports[t].out = &logs[t];
+    }
+  }
+
+  std::vector<int> status(traces.size(), 0);
+  size_t workers = batch ? 1 : std::min(threads, traces.size());
+#ifdef SCHED_COUNTERS
+  std::vector<SchedCounters> counters(workers);
+#endif
+  if (batch) {
+    int s = batchRR(opts, traces, reports);
+    status.assign(traces.size(), s);
+  } else {
+    // Each worker takes the next unclaimed trace; output stays per trace so
+    // it can be printed in input order afterwards.
+    std::atomic<size_t> next(0);
+    auto worker = [&](size_t w) {
+      for (size_t t; (t = next++) < traces.size();) {
+        SchedOptions traceOpts = opts;
+        traceOpts.trace = traces[t].c_str();
+        status[t] = policies.at(policy)(traceOpts, reports[t]);
+      }
+#ifdef SCHED_COUNTERS
+      schedCountersTake(&counters[w]);
+#else
+      (void)w;
+#endif
+    };
+    std::vector<std::thread> pool;
+    for (size_t w = 1; w < workers; w++) {
+      pool.emplace_back(worker, w);
+    }
+    worker(0);
+    for (auto& thread : pool) {
+      thread.join();
+    }
+  }
+
+  int failed = 0;
+  for (size_t t = 0; t < traces.size(); t++) {
+    if (status[t]) {
+      std::cerr << argv[0] << ": " << traces[t] << ": " << policy
+                << " failed\n";
+      failed = 1;
+      continue;
+    }
+    if (opts.format == FORMAT_TEXT) {
+      if (traces.size() > 1) {
+        std::cout << (t ? "\n" : "") << "==> " << traces[t] << " <==\n";
+      }
+      std::cout << logs[t].str() << std::endl;
+    } else {
+      std::cerr << logs[t].str();
+    }
+  }
+  if (opts.format == FORMAT_JSON) {
+    printJSON(traces, policy, reports);
+  } else if (opts.format == FORMAT_CSV) {
+    printCSV(traces, policy, reports);
+  }
+#ifdef SCHED_COUNTERS
+  // Only the rr, vrr, sjf and srtf loops carry COUNT/TIME hooks.
+  static const std::set<std::string> instrumented = {"rr", "vrr", "sjf",
+                                                     "srtf"};
+  if (batch) {
+    std::cerr << argv[0] << ": no counters: the batch engine is not"
+              << " instrumented\n";
+  } else if (!instrumented.count(policy)) {
+    std::cerr << argv[0] << ": no counters: " << policy << " is not"
+              << " instrumented\n";
+  } else {
+    schedCountersJSON(stderr, counters.data(), counters.size());
+  }
+#endif
+  return failed;
+}
@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <ostream>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "share.h"
+#include "trace.h"
+
+namespace share {
+
+namespace {
+
+class Device {
+ public:
+  Device() {}
+  bool init(Selector& selector,
+            Processes& procs,
+            const SchedOptions& opts,
+            Report& report) {
+    this->selector = &selector;
+    this->procs = procs;
+    std::stable_sort(this->procs.begin(), this->procs.end(),
+                     [](const Process& a, const Process& b) {
+                       return a.arrivalTime < b.arrivalTime;
+                     });
+    totalProc = procs.size();
+    timeQuantum = opts.timeQuantum;
+    logProcs = opts.logLevel >= LOG_PROCESS;
+    trace = report.trace;
+    out = report.out;
+    return selector.init(this->procs);
+  }
+
+  void processor() {
+    size_t q = 0;
+    LOG("Time (tick)", "Device", "Process Served")
+    while (totalProc) {
+      LOG_TICK(ticksCPU)
+      if (isCPUIdle) {
+        LOG("\t", "CPU", "-");
+      }
+      FreshArrivals();
+
+      if (!isCPUIdle) {
+        Process& execProc = procs[execSlot];
+        size_t runnableTickets = readyTickets + execProc.tickets;
+        shareClock += 1.0 / runnableTickets;
+        selector->ran(execSlot, runnableTickets);
+        execProc.exec();
+        if (execProc.state == Process::State::TERMINATED) {
+          LOG("\t", "CPU", execProc.procName << "[Comp]");
+          leaveShare(execSlot);
+          isCPUIdle = true;
+          totalProc--;
+          execProc.completionTime = ticksCPU;
+          completedProcs.push_back(execSlot);
+        } else if (execProc.state == Process::State::BLOCKED) {
+          LOG("\t", "CPU",
+              execProc.procName << "[Q IO]:" << execProc.burstRemainCPU);
+          leaveShare(execSlot);
+          ioQ.push(execSlot);
+          isCPUIdle = true;
+        } else {
+          LOG("\t", "CPU", execProc.procName << ":" << execProc.burstRemainCPU)
+        }
+      }
+
+      bool toSchedule = readyTickets && (isCPUIdle || q + 1 >= timeQuantum);
+      if (toSchedule) {
+        if (!isCPUIdle) {
+          procs[execSlot].state = Process::State::READY;
+          selector->requeue(execSlot);
+          readyTickets += procs[execSlot].tickets;
+        }
+        size_t winner = selector->pick();
+        readyTickets -= procs[winner].tickets;
+        if (isCPUIdle) {
+          LOG("\t", "CPU", procs[winner].procName << "[Sched]")
+        } else if (winner != execSlot) {
+          LOG("\t", "CPU",
+              procs[execSlot].procName << "[Preempt]->"
+                                       << procs[winner].procName)
+        } else {
+          LOG("\t", "CPU",
+              procs[winner].procName << "[" << selector->renewal << "]")
+        }
+        if (!isCPUIdle) {
+          sampleShare(procs[execSlot]);
+        }
+        sampleShare(procs[winner]);
+        execSlot = winner;
+        procs[execSlot].state = Process::State::RUNNING;
+        procs[execSlot].startTime =
+            std::min(procs[execSlot].startTime, ticksCPU);
+        isCPUIdle = false;
+        q = -1;
+      }
+
+      ioDevice();
+      ticksCPU++;
+      q++;
+      if (trace) {
+        *trace << "\n";
+      }
+    }
+  }
+
+  void ioDevice() {
+    if (!isIOIdle) {
+      Process& execProcIO = procs[ioSlot];
+      if (++countIOBurst >= execProcIO.burstTimeIO) {
+        LOG("\t", "IO", execProcIO.procName << "[Comp]:" << countIOBurst)
+        joinShare(ioSlot);
+        isIOIdle = true;
+      } else {
+        LOG("\t", "IO", execProcIO.procName << ":" << countIOBurst)
+      }
+    }
+
+    if (isIOIdle && !ioQ.empty()) {
+      ioSlot = ioQ.front();
+      ioQ.pop();
+      countIOBurst = 0;
+      isIOIdle = false;
+      LOG("\t", "IO", procs[ioSlot].procName << "[Sched]:" << countIOBurst)
+    }
+  }
+
+  void debug(Report& report) {
+    size_t allTickets = 0;
+    for (auto& proc : procs) {
+      allTickets += proc.tickets;
+    }
+    for (auto slot : completedProcs) {
+      Process& proc = procs[slot];
+      if (out && logProcs) {
+        LOG_DEBUG(proc.procName, "Arrival Time:\t", proc.arrivalTime)
+        LOG_DEBUG("", "Start Time:\t", proc.startTime)
+        LOG_DEBUG("", "Response Time:\t", proc.responseTime())
+        LOG_DEBUG("", "Completion Time:", proc.completionTime)
+        LOG_DEBUG("", "Turnaround Time:", proc.turnAroundTime())
+        LOG_DEBUG("", "Waiting Time:\t", proc.waitingTime())
+        LOG_DEBUG("", "Tickets:\t", proc.tickets << " ("
+                  << 100.0 * proc.tickets / allTickets << "%)")
+        LOG_DEBUG("", "Expected CPU:\t", proc.expectedCPU)
+        LOG_DEBUG("", "Max Share Error:", proc.maxShareError << "\n")
+      }
+      report.addProcess(proc.procName, proc.arrivalTime, proc.burstTimeCPU,
+                        proc.startTime, proc.completionTime,
+                        proc.waitingTime());
+      report.addMetric(proc.procName + ".maxShareError", proc.maxShareError);
+    }
+    report.addMetric("avgWaitingTime", avgWaitingTime());
+    report.addMetric("maxShareError", maxShareError());
+    if (out) {
+      *out << "Avg Waiting Time: " << avgWaitingTime() << "\n";
+      *out << "Max Share Error: " << maxShareError();
+    }
+  }
+
+  double avgWaitingTime() {
+    double sum = 0;
+    for (auto slot : completedProcs) {
+      sum += procs[slot].waitingTime();
+    }
+    return (double)(sum / completedProcs.size());
+  }
+
+  // Largest gap, in CPU ticks, between what any process received and what
+  // its ticket share of the runnable set entitled it to at any point.
+  double maxShareError() {
+    double worst = 0;
+    for (auto& proc : procs) {
+      worst = std::max(worst, proc.maxShareError);
+    }
+    return worst;
+  }
+
+ private:
+  std::vector<size_t> completedProcs = {};
+  Processes procs = {};
+  size_t nextArrival = 0;
+  size_t totalProc = 0;
+  size_t ticksCPU = 0;
+  size_t timeQuantum = 5;
+  bool logProcs = true;
+  std::ostream* trace = nullptr;
+  std::ostream* out = nullptr;
+  bool isCPUIdle = true;
+  size_t execSlot = 0;
+
+  size_t countIOBurst = 0;
+  bool isIOIdle = true;
+  size_t ioSlot = 0;
+
+  Selector* selector = nullptr;
+  size_t readyTickets = 0;  // held by READY processes
+  std::queue<size_t> ioQ;
+
+  // Advances by 1/T on every busy tick, T being the tickets of the runnable
+  // set, so a process holding t tickets is owed t * (elapsed clock) ticks.
+  double shareClock = 0;
+
+  void joinShare(size_t slot) {
+    Process& proc = procs[slot];
+    proc.state = Process::State::READY;
+    proc.shareJoin = shareClock;
+    selector->join(slot);
+    readyTickets += proc.tickets;
+  }
+
+  void leaveShare(size_t slot) {
+    Process& proc = procs[slot];
+    sampleShare(proc);
+    proc.expectedCPU += proc.tickets * (shareClock - proc.shareJoin);
+    proc.shareJoin = shareClock;
+    selector->leave(slot);
+  }
+
+  // The error of a process only changes direction when it is dispatched,
+  // descheduled or leaves the runnable set, so sampling there is exact.
+  void sampleShare(Process& proc) {
+    proc.maxShareError =
+        std::max(proc.maxShareError, std::fabs(proc.shareError(shareClock)));
+  }
+
+  void FreshArrivals() {
+    while (nextArrival < procs.size() &&
+           procs[nextArrival].arrivalTime <= ticksCPU) {
+      LOG("\t", "CPU", procs[nextArrival].procName << "[Arrive]")
+      joinShare(nextArrival);
+      nextArrival++;
+    }
+  }
+};
+
+// Function to build processes from trace entries; tickets are optional
+Processes toProcesses(TraceEntries& entries) {
+  Processes processes;
+  for (auto& entry : entries) {
+    auto& f = entry.fields;
+    size_t tickets = f.size() > 4 ? f[4] : 1;
+    processes.push_back(
+        Process(std::move(entry.name), f[0], f[1], f[2], f[3], tickets));
+  }
+  return processes;
+}
+
+}  // namespace
+
+int run(Selector& selector, const SchedOptions& opts, Report& report) {
+  if (opts.cpus != 1 || opts.ios != 1) {
+    std::cerr << selector.name << ": only one CPU and one IO device are modelled"
+              << std::endl;
+    return 1;
+  }
+
+  // Read processes from input file
+  TraceEntries entries;
+  if (!readTrace(opts.trace, 4, SIZE_MAX, entries)) {
+    return 1;
+  }
+  Processes procs = toProcesses(entries);
+
+  // Check if processes were successfully read
+  if (procs.empty()) {
+    std::cerr << "No processes were read from " << opts.trace << std::endl;
+    return 1;
+  }
+  Device d;
+  if (!d.init(selector, procs, opts, report)) {
+    return 1;
+  }
+  d.processor();
+  d.debug(report);
+
+  return 0;
+}
+
+}  // namespace share
@@ -0,0 +1,104 @@
+#ifndef SHARE_H
+#define SHARE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "policies.h"
+
+// Proportional-share scheduling: the device, the share accounting and the
+// ticket-trace reader behind lottery.cpp and stride.cpp. Each policy
+// supplies only a Selector, the structure it picks READY processes from.
+
+namespace share {
+
+typedef struct Process {
+  enum State { READY, RUNNING, BLOCKED, TERMINATED };
+  std::string procName;
+  size_t arrivalTime = SIZE_MAX;
+  size_t burstTimeCPU = SIZE_MAX;
+  size_t burstTimeIO = SIZE_MAX;
+  size_t burstTimeRate = SIZE_MAX;  // IO burst after every n CPU bursts
+  size_t tickets = 1;
+  size_t startTime = SIZE_MAX;
+  size_t completionTime;
+  size_t burstRemainCPU = SIZE_MAX;
+  size_t lastIOBurst = 0;
+  double expectedCPU = 0;  // CPU ticks owed by its share while runnable
+  double shareJoin = 0;    // share clock when it last became runnable
+  double maxShareError = 0;
+  State state;
+
+  Process() {}
+  Process(std::string&& name,
+          size_t at,
+          size_t btCPU,
+          size_t btIO,
+          size_t btr,
+          size_t tkt) {
+    procName = std::move(name);
+    arrivalTime = at;
+    burstTimeCPU = btCPU;
+    burstRemainCPU = btCPU;
+    burstTimeIO = btIO;
+    burstTimeRate = btr;
+    tickets = std::max<size_t>(tkt, 1);
+  }
+  State exec() {
+    state = State::RUNNING;
+    if (--burstRemainCPU <= 0) {
+      state = State::TERMINATED;
+    } else if (++lastIOBurst >= burstTimeRate) {
+      refreshIOBurst();
+      state = State::BLOCKED;
+    }
+    return state;
+  }
+  void refreshIOBurst() { lastIOBurst = 0; }
+  size_t turnAroundTime() { return completionTime - arrivalTime; }
+  size_t waitingTime() { return turnAroundTime() - burstTimeCPU; }
+  size_t responseTime() { return startTime - arrivalTime; }
+  size_t receivedCPU() { return burstTimeCPU - burstRemainCPU; }
+  double shareError(double shareClock) {
+    return receivedCPU() - (expectedCPU + tickets * (shareClock - shareJoin));
+  }
+} Process;
+typedef std::vector<Process> Processes;
+
+// Holds the READY processes of one run, by slot, and picks the next one
+// to run. The device keeps the share accounting around it.
+class Selector {
+ public:
+  Selector(const char* name, const char* renewal)
+      : name(name), renewal(renewal) {}
+  virtual ~Selector() {}
+
+  // Called once with every process, in slot order. Returns false, having
+  // said why on stderr, if the policy cannot schedule them.
+  virtual bool init(const Processes& procs) = 0;
+  // The process becomes runnable: it arrived or finished its IO.
+  virtual void join(size_t slot) = 0;
+  // The process stops being runnable: it blocked on IO or completed.
+  virtual void leave(size_t slot) = 0;
+  // The running process goes back to READY when its quantum ends.
+  virtual void requeue(size_t slot) = 0;
+  // Removes and returns the next process to run; some process is READY.
+  virtual size_t pick() = 0;
+  // The running process used one CPU tick, out of `runnableTickets`.
+  virtual void ran(size_t slot, uint64_t runnableTickets) = 0;
+
+  const char* name;     // for error messages
+  const char* renewal;  // logged when a process is picked again
+};
+
+// Reads a ticket trace from opts.trace and runs it under `selector`.
+// Returns 0 on success, or prints why to stderr and returns 1.
+int run(Selector& selector, const SchedOptions& opts, Report& report);
+
+}  // namespace share
+
+#endif
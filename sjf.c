@@ -3,141 +3,246 @@
 #include <string.h>
 #include <stdbool.h>
 
+#include "counters.h"
+#include "policies.h"
+
 #define MAX_PROCESSES 100
 
-struct Process {
-    char name[5];
-    int arrivalTime, burstTime, remainingTime;
+// What the scheduling loops scan every tick, two to a cache line
+struct HotProcess {
+    _Alignas(32) int arrivalTime;
+    int burstTime, remainingTime;
     int ioInterval, ioDuration;
-    int waitingTime, turnaroundTime, completionTime, responseTime;
     int insertedIOtime;  // To track when the process entered IO
+    int waitingTime;
     bool inIO, executed;
 };
 
-struct Process processes[MAX_PROCESSES];
-int processCount = 0;
+// Name and results, read once per dispatch or when reporting
+struct Process {
+    char name[5];
+    int turnaroundTime, completionTime, responseTime;
+};
 
 // Function to read process data from file
-void readData(char *filename) {
+static int readData(const char *filename, struct HotProcess *hot,
+                    struct Process *processes, int *count) {
     FILE *file = fopen(filename, "r");
     if (!file) {
         perror("Error opening file");
-        exit(1);
+        return 1;
     }
 
-    while (fscanf(file, "%[^;];%d;%d;%d;%d\n",
-                  processes[processCount].name,
-                  &processes[processCount].arrivalTime,
-                  &processes[processCount].burstTime,
-                  &processes[processCount].ioInterval,
-                  &processes[processCount].ioDuration) != EOF) {
-        processes[processCount].remainingTime = processes[processCount].burstTime;
-        processes[processCount].waitingTime = 0;
-        processes[processCount].turnaroundTime = 0;
-        processes[processCount].completionTime = 0;
-        processes[processCount].responseTime = -1;
-        processes[processCount].inIO = false;
-        processes[processCount].executed = false;
-        processes[processCount].insertedIOtime = -1;
-        processCount++;
+    // One process per line: name;arrival;burst;ioInterval;ioDuration, with
+    // any further fields ignored. A line that does not parse, a name longer
+    // than 4 characters, a burst below 1, a negative field or more than
+    // MAX_PROCESSES processes is an error, never a shorter trace.
+    char line[256], name[6];
+    int processCount = 0, lineNo = 0, status = 0;
+    while (status == 0 && fgets(line, sizeof(line), file)) {
+        lineNo++;
+        if (line[strspn(line, " \t\r\n")] == '\0') {
+            continue;
+        }
+        if (!strchr(line, '\n') && !feof(file)) {
+            fprintf(stderr, "%s:%d: line too long\n", filename, lineNo);
+            status = 1;
+        } else if (processCount == MAX_PROCESSES) {
+            fprintf(stderr, "%s:%d: more than %d processes\n", filename, lineNo,
+                    MAX_PROCESSES);
+            status = 1;
+        } else if (sscanf(line, " %5[^;];%d;%d;%d;%d", name,
+                          &hot[processCount].arrivalTime,
+                          &hot[processCount].burstTime,
+                          &hot[processCount].ioInterval,
+                          &hot[processCount].ioDuration) != 5 ||
+                   strlen(name) > 4) {
+            fprintf(stderr, "%s:%d: expected name;arrival;burst;ioInterval;"
+                            "ioDuration with a name of at most 4 characters\n",
+                    filename, lineNo);
+            status = 1;
+        } else if (hot[processCount].burstTime < 1 ||
+                   hot[processCount].arrivalTime < 0 ||
+                   hot[processCount].ioInterval < 0 ||
+                   hot[processCount].ioDuration < 0) {
+            fprintf(stderr, "%s:%d: burst must be at least 1 and arrival, "
+                            "ioInterval and ioDuration non-negative\n",
+                    filename, lineNo);
+            status = 1;
+        } else {
+            strcpy(processes[processCount].name, name);
+            hot[processCount].remainingTime = hot[processCount].burstTime;
+            hot[processCount].waitingTime = 0;
+            processes[processCount].turnaroundTime = 0;
+            processes[processCount].completionTime = 0;
+            processes[processCount].responseTime = -1;
+            hot[processCount].inIO = false;
+            hot[processCount].executed = false;
+            hot[processCount].insertedIOtime = -1;
+            processCount++;
+        }
     }
 
     fclose(file);
+    *count = processCount;
+    return status;
 }
 
-// Function to print the scheduling results
-void printProcesses() {
-    printf("\nProcess Execution Results:\n");
-    printf("------------------------------------------------------------\n");
-    printf("PID  Arrival  Burst  Completion  Turnaround  Waiting  Response\n");
-    float AWT,ATAT,ART;
+// Number of processes waiting on I/O, for the counters
+static inline int ioDepth(const struct HotProcess *hot, int processCount) {
+    int depth = 0;
+    for (int i = 0; i < processCount; i++) {
+        depth += hot[i].inIO;
+    }
+    return depth;
+}
+
+// Function to report the scheduling results
+static void printProcesses(struct HotProcess *hot, struct Process *processes,
+                           int processCount, bool showProcesses,
+                           struct SchedReport *report) {
+    FILE *out = report->out;
+    if (out && showProcesses) {
+        fprintf(out, "\nProcess Execution Results:\n");
+        fprintf(out, "------------------------------------------------------------\n");
+        fprintf(out, "PID  Arrival  Burst  Completion  Turnaround  Waiting  Response\n");
+    }
+    float AWT = 0, ATAT = 0, ART = 0;
 
     for (int i = 0; i < processCount; i++) {
-        printf("%-4s %-8d %-6d %-11d %-11d %-7d %-7d\n",
-               processes[i].name,
-               processes[i].arrivalTime,
-               processes[i].burstTime,
-               processes[i].completionTime,
-               processes[i].turnaroundTime,
-               processes[i].waitingTime,
-               processes[i].responseTime
-    );
-    AWT+=processes[i].waitingTime;
+        if (out && showProcesses) {
+            fprintf(out, "%-4s %-8d %-6d %-11d %-11d %-7d %-7d\n",
+                   processes[i].name,
+                   hot[i].arrivalTime,
+                   hot[i].burstTime,
+                   processes[i].completionTime,
+                   processes[i].turnaroundTime,
+                   hot[i].waitingTime,
+                   processes[i].responseTime
+            );
+        }
+        struct SchedProc proc = {0};
+        memcpy(proc.name, processes[i].name, sizeof(processes[i].name));
+        proc.arrivalTime = hot[i].arrivalTime;
+        proc.burstTime = hot[i].burstTime;
+        proc.startTime = hot[i].arrivalTime + processes[i].responseTime;
+        proc.completionTime = processes[i].completionTime;
+        proc.turnaroundTime = processes[i].turnaroundTime;
+        proc.waitingTime = hot[i].waitingTime;
+        proc.responseTime = processes[i].responseTime;
+        report->addProcess(report->ctx, &proc);
+    AWT+=hot[i].waitingTime;
     ATAT+=processes[i].turnaroundTime;
     ART+=processes[i].responseTime;
     }
 
-    printf("\nAverage Waiting Time : %f\n",(float)(AWT/(float)processCount));
-    printf("Average TurnAround Time : %f\n",(float)(ATAT/(float)processCount));
-    printf("Average Response Time : %f\n",(float)(ART/(float)processCount));
+    report->addMetric(report->ctx, "avgWaitingTime", AWT/(float)processCount);
+    report->addMetric(report->ctx, "avgTurnaroundTime", ATAT/(float)processCount);
+    report->addMetric(report->ctx, "avgResponseTime", ART/(float)processCount);
+    if (!out) {
+        return;
+    }
+    fprintf(out, "\nAverage Waiting Time : %f\n",(float)(AWT/(float)processCount));
+    fprintf(out, "Average TurnAround Time : %f\n",(float)(ATAT/(float)processCount));
+    fprintf(out, "Average Response Time : %f\n",(float)(ART/(float)processCount));
 
-    printf("------------------------------------------------------------\n");
+    fprintf(out, "------------------------------------------------------------\n");
 }
 
 // Shortest Job First (SJF) Non-Preemptive Scheduling 
-void sjf() {
-    printf("\nExecuting SJF (Non-Preemptive) ...\n");
+int sjf(const struct SchedOptions *opts, struct SchedReport *report) {
+    if (opts->cpus != 1 || opts->ios != 1) {
+        fprintf(stderr, "sjf: only one CPU and one IO device are modelled\n");
+        return 1;
+    }
+
+    _Alignas(64) struct HotProcess hot[MAX_PROCESSES];
+    struct Process processes[MAX_PROCESSES];
+    int processCount = 0;
+    if (readData(opts->trace, hot, processes, &processCount)) {
+        return 1;
+    }
+    if (processCount == 0) {
+        fprintf(stderr, "No processes were read from %s\n", opts->trace);
+        return 1;
+    }
+
+    if (report->out) {
+        fprintf(report->out, "\nExecuting SJF (Non-Preemptive) ...\n");
+    }
 
     int completed = 0, time = 0;
+    int lastExecuted = -1;
 
     while (completed < processCount) {
         int minIdx = -1;
 
         // Check if any process has completed its I/O and can return to CPU
+        TIME_BEGIN(PHASE_IO)
         for (int i = 0; i < processCount; i++) {
-            if (processes[i].inIO && (time - processes[i].insertedIOtime) >= processes[i].ioInterval) {
-                processes[i].inIO = false;
-                processes[i].insertedIOtime = -1;
+            if (hot[i].inIO && (time - hot[i].insertedIOtime) >= hot[i].ioInterval) {
+                hot[i].inIO = false;
+                hot[i].insertedIOtime = -1;
+                COUNT_POP(QUEUE_IO);
             }
         }
+        TIME_END(PHASE_IO)
 
         // Find the shortest available job (not in I/O and arrived)
+        TIME_BEGIN(PHASE_DISPATCH)
         for (int i = 0; i < processCount; i++) {
-            if (!processes[i].executed && !processes[i].inIO && processes[i].arrivalTime <= time) {
-                if (minIdx == -1 || processes[i].remainingTime < processes[minIdx].remainingTime) {
+            if (!hot[i].executed && !hot[i].inIO && hot[i].arrivalTime <= time) {
+                if (minIdx == -1 || hot[i].remainingTime < hot[minIdx].remainingTime) {
                     minIdx = i;
                 }
             }
         }
+        TIME_END(PHASE_DISPATCH)
 
         // If no process is available, increment time
         if (minIdx == -1) {
+            COUNT(ticks);
+            COUNT(idleTicks);
+            COUNT_IF(ioStalls, ioDepth(hot, processCount) > 0);
             time++;
             continue;
         }
+        if (minIdx != lastExecuted) {
+            COUNT(contextSwitches);
+            lastExecuted = minIdx;
+        }
 
         // Set response time if it's the first execution of the process
         if (processes[minIdx].responseTime == -1) {
-            processes[minIdx].responseTime = time - processes[minIdx].arrivalTime;
+            processes[minIdx].responseTime = time - hot[minIdx].arrivalTime;
         }
 
-        // Execute the process in chunks until it finishes or requires I/O
-        int executedTime = (processes[minIdx].remainingTime < processes[minIdx].ioDuration) ? 
-                           processes[minIdx].remainingTime : processes[minIdx].ioDuration;
+        // Execute the process in chunks until it finishes or requires I/O;
+        // a zero chunk length means it never does I/O
+        int executedTime = (hot[minIdx].ioDuration == 0 ||
+                            hot[minIdx].remainingTime < hot[minIdx].ioDuration) ?
+                           hot[minIdx].remainingTime : hot[minIdx].ioDuration;
 
         time+=executedTime;
-        processes[minIdx].remainingTime-=executedTime;
+        hot[minIdx].remainingTime-=executedTime;
+        COUNT_ADD(ticks, executedTime);
 
         // If process is completed
-        if (processes[minIdx].remainingTime == 0) {
-            processes[minIdx].executed = true;
-            processes[minIdx].waitingTime=time-processes[minIdx].arrivalTime-processes[minIdx].burstTime;
+        if (hot[minIdx].remainingTime == 0) {
+            hot[minIdx].executed = true;
+            hot[minIdx].waitingTime=time-hot[minIdx].arrivalTime-hot[minIdx].burstTime;
             processes[minIdx].completionTime = time;
-            processes[minIdx].turnaroundTime = processes[minIdx].completionTime - processes[minIdx].arrivalTime;
+            processes[minIdx].turnaroundTime = processes[minIdx].completionTime - hot[minIdx].arrivalTime;
             completed++;
         } 
         // If process needs I/O
         else {
-            processes[minIdx].inIO = true;
-            processes[minIdx].insertedIOtime = time;
+            hot[minIdx].inIO = true;
+            hot[minIdx].insertedIOtime = time;
+            COUNT_PUSH(QUEUE_IO, ioDepth(hot, processCount));
         }
     }
 
-    printProcesses();
-}
-
-int main() {
-    readData("processes.txt");
-    sjf();
+    printProcesses(hot, processes, processCount, opts->logLevel >= LOG_PROCESS, report);
     return 0;
 }
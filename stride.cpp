@@ -0,0 +1,80 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "share.h"
+
+namespace {
+
+using share::Processes;
+
+// Strides are stride1 / tickets. stride() rejects traces whose tickets
+// total more than stride1, so no stride and no global pass step truncates
+// to 0. A one-ticket process's pass grows by 2^32 per tick, which leaves
+// 2^32 ticks of headroom in 64 bits.
+const uint64_t stride1 = (uint64_t)1 << 32;
+
+class StrideSelector : public share::Selector {
+ public:
+  StrideSelector() : Selector("stride", "Renew") {}
+
+  bool init(const Processes& procs) override {
+    uint64_t totalTickets = 0;
+    for (auto& proc : procs) {
+      totalTickets += proc.tickets;
+    }
+    if (totalTickets > stride1) {
+      std::cerr << "stride: the trace holds " << totalTickets
+                << " tickets, more than the " << stride1 << " supported"
+                << std::endl;
+      return false;
+    }
+    stride.resize(procs.size());
+    for (size_t slot = 0; slot < procs.size(); slot++) {
+      stride[slot] = stride1 / procs[slot].tickets;
+    }
+    pass.assign(procs.size(), 0);
+    passRemain = stride;
+    return true;
+  }
+  void join(size_t slot) override {
+    pass[slot] = globalPass + passRemain[slot];
+    requeue(slot);
+  }
+  void leave(size_t slot) override {
+    passRemain[slot] = pass[slot] > globalPass ? pass[slot] - globalPass : 0;
+  }
+  void requeue(size_t slot) override { readyQ.push({pass[slot], slot}); }
+  // Lowest pass runs next.
+  size_t pick() override {
+    size_t winner = readyQ.top().second;
+    readyQ.pop();
+    return winner;
+  }
+  void ran(size_t slot, uint64_t runnableTickets) override {
+    globalPass += stride1 / runnableTickets;
+    pass[slot] += stride[slot];
+  }
+
+ private:
+  std::vector<uint64_t> stride;      // stride1 / tickets, pass per CPU tick
+  std::vector<uint64_t> pass;
+  std::vector<uint64_t> passRemain;  // pass ahead of the global pass on leaving
+  uint64_t globalPass = 0;
+  // READY processes keyed by pass, ties broken by arrival order.
+  std::priority_queue<std::pair<uint64_t, size_t>,
+                      std::vector<std::pair<uint64_t, size_t>>,
+                      std::greater<std::pair<uint64_t, size_t>>>
+      readyQ;
+};
+
+}  // namespace
+
+int stride(const SchedOptions& opts, Report& report) {
+  StrideSelector selector;
+  return share::run(selector, opts, report);
+}
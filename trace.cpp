@@ -0,0 +1,100 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <istream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "trace.h"
+
+namespace {
+
+const char* const blanks = " \t\r";
+
+std::string trim(const std::string& s) {
+  size_t begin = s.find_first_not_of(blanks);
+  if (begin == std::string::npos) {
+    return "";
+  }
+  return s.substr(begin, s.find_last_not_of(blanks) + 1 - begin);
+}
+
+// Digits only: std::stoul would take "-5" and wrap it, and throws on text.
+bool parseField(const std::string& text, size_t& value) {
+  if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  errno = 0;
+  unsigned long long n = strtoull(text.c_str(), nullptr, 10);
+  if (errno == ERANGE || n > SIZE_MAX) {
+    return false;
+  }
+  value = n;
+  return true;
+}
+
+}  // namespace
+
+bool readTrace(std::istream& input,
+               const std::string& source,
+               size_t required,
+               size_t limit,
+               TraceEntries& entries) {
+  std::string line;
+  for (size_t lineNo = 1; std::getline(input, line); lineNo++) {
+    if (trim(line).empty()) {
+      continue;
+    }
+    std::vector<std::string> parts;
+    std::stringstream ss(line);
+    for (std::string part; std::getline(ss, part, ';');) {
+      parts.push_back(trim(part));
+    }
+    while (parts.size() > 1 && parts.back().empty()) {
+      parts.pop_back();
+    }
+
+    std::string why;
+    TraceEntry entry;
+    entry.name = parts[0];
+    if (parts.size() < required + 1) {
+      why = "expected a name and " + std::to_string(required) + " fields";
+    }
+    for (size_t i = 1; why.empty() && i < parts.size(); i++) {
+      size_t value = 0;
+      if (!parseField(parts[i], value)) {
+        why = "field " + std::to_string(i + 1) + " (\"" + parts[i] +
+              "\") is not a non-negative integer";
+      } else if (value > limit) {
+        why = "field " + std::to_string(i + 1) + " (\"" + parts[i] +
+              "\") is above " + std::to_string(limit);
+      }
+      entry.fields.push_back(value);
+    }
+    if (why.empty() && entry.fields.size() > 1 && entry.fields[1] < 1) {
+      why = "CPU burst must be at least 1";
+    }
+    if (!why.empty()) {
+      std::cerr << source << ":" << lineNo << ": " << why << std::endl;
+      return false;
+    }
+    entries.push_back(std::move(entry));
+  }
+  return true;
+}
+
+bool readTrace(const std::string& filename,
+               size_t required,
+               size_t limit,
+               TraceEntries& entries) {
+  std::ifstream inputFile(filename);
+  if (!inputFile.is_open()) {
+    std::cerr << "Error: Unable to open file " << filename << std::endl;
+    return false;
+  }
+  return readTrace(inputFile, filename, required, limit, entries);
+}
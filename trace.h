@@ -0,0 +1,35 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+// The trace reader behind every C++ policy. A trace has one entry per line:
+// a name, then ';'-separated non-negative integers, as in P0;0;24;2;5. The
+// second integer is always a CPU burst and must be at least 1. Blank lines
+// are skipped, and so are empty fields at the end of a line.
+
+typedef struct TraceEntry {
+  std::string name;
+  std::vector<size_t> fields;  // at least as many as the reader required
+} TraceEntry;
+typedef std::vector<TraceEntry> TraceEntries;
+
+// Appends every entry of the trace to `entries`, requiring `required`
+// fields per line; any further fields must also be integers, and no field
+// may exceed `limit`, the largest value the caller's storage holds. On the
+// first line that breaks the format, prints "source:line: why" to stderr
+// and returns false.
+bool readTrace(std::istream& input,
+               const std::string& source,
+               size_t required,
+               size_t limit,
+               TraceEntries& entries);
+bool readTrace(const std::string& filename,
+               size_t required,
+               size_t limit,
+               TraceEntries& entries);
+
+#endif
@@ -8,14 +8,12 @@
 #include <string>
 #include <utility>
 #include <vector>
-#include <fstream>
-#include <sstream>
 
-#define LOG_TICK(ticks) std::cout << ticks;
-#define LOG(tick, device, procData) \
-  std::cout << tick << "\t" << device << "\t\t" << procData << "\n";
-#define LOG_DEBUG(name, label, info) \
-  std::cout << name << "\n\t\t" << label "\t" << info;
+#include "counters.h"
+#include "policies.h"
+#include "trace.h"
+
+namespace {
 
 typedef struct Process {
   enum State { READY, RUNNING, BLOCKED, TERMINATED };
@@ -61,106 +59,179 @@ typedef struct Process {
 } Process;
 typedef std::vector<Process> Processes;
 
+typedef struct CPU {
+  std::string deviceName;
+  Process execProc;
+  int q = 0;
+  bool isCPUIdle = true;
+} CPU;
+
+typedef struct IO {
+  std::string deviceName;
+  Process execProcIO;
+  size_t countIOBurst = 0;
+  bool isIOIdle = true;
+} IO;
+
 class Device {
  public:
   Device() {}
-  void init(Processes& procs) {
+  void init(Processes& procs, const SchedOptions& opts, Report& report) {
     this->procs = procs;
     totalProc = procs.size();
+    timeQuantum = opts.timeQuantum;
+    logProcs = opts.logLevel >= LOG_PROCESS;
+    trace = report.trace;
+    out = report.out;
+    cpus.resize(opts.cpus);
+    for (size_t i = 0; i < cpus.size(); i++) {
+      cpus[i].deviceName = cpus.size() > 1 ? "CPU" + std::to_string(i) : "CPU";
+    }
+    ios.resize(opts.ios);
+    for (size_t i = 0; i < ios.size(); i++) {
+      ios[i].deviceName = ios.size() > 1 ? "IO" + std::to_string(i) : "IO";
+    }
   }
 
   void processor() {
-    Process execProc;
-    int q = 0;
     LOG("Time (tick)", "Device", "Process Served")
     while (totalProc) {
       LOG_TICK(ticksCPU)
-      if (isCPUIdle) {
-        LOG("\t", "CPU", "-");
+      COUNT(ticks);
+      for (auto& cpu : cpus) {
+        if (cpu.isCPUIdle) {
+          LOG("\t", cpu.deviceName, "-");
+          COUNT(idleTicks);
+          COUNT_IF(ioStalls, waitingOnIO());
+        }
       }
+      TIME_BEGIN(PHASE_ARRIVAL)
       FreshArrivals();
+      TIME_END(PHASE_ARRIVAL)
 
-      if (!isCPUIdle) {
-        execProc.exec();
-        if (execProc.state == Process::State::TERMINATED) {
-          LOG("\t", "CPU", execProc.procName << "[Comp]");
-          isCPUIdle = true;
-          totalProc--;
-          execProc.completionTime = ticksCPU;
-          completedProcs.push_back(execProc);
-          execProc = {};
-        } else if (execProc.state == Process::State::BLOCKED) {
-          LOG("\t", "CPU",
-              execProc.procName << "[Q IO]:" << execProc.burstRemainCPU);
-          execProc.saveContextOfq = (q + 1) % timeQuantum;
-          ioQ.push(execProc);
-          isCPUIdle = true;
-          execProc = {};
-        } else {
-          LOG("\t", "CPU", execProc.procName << ":" << execProc.burstRemainCPU)
-        }
+      TIME_BEGIN(PHASE_DISPATCH)
+      for (auto& cpu : cpus) {
+        execute(cpu);
+      }
+      for (auto& cpu : cpus) {
+        schedule(cpu);
       }
+      TIME_END(PHASE_DISPATCH)
+      TIME_BEGIN(PHASE_IO)
+      for (auto& io : ios) {
+        ioDevice(io);
+      }
+      TIME_END(PHASE_IO)
+      ticksCPU++;
+      for (auto& cpu : cpus) {
+        cpu.q++;
+      }
+      if (trace) {
+        *trace << "\n";
+      }
+    }
+  }
 
-      bool toSchedule = (!readyQ.empty() || !auxQ.empty()) &&
-                        (isCPUIdle || q + 1 >= timeQuantum);
-      if (toSchedule) {
-        Process proc;
-        if (!auxQ.empty()) {
-          proc = auxQ.front();
-          auxQ.pop();
-          q = proc.saveContextOfq - 1;
-        } else {
-          proc = readyQ.front();
-          readyQ.pop();
-          q = -1;
-        }
-        if (!isCPUIdle) {
-          readyQ.push(execProc);
-        }
-        LOG("\t", "CPU", proc.procName << "[Sched]#q=" << q + 1)
-        execProc = proc;
-        execProc.startTime = std::min(execProc.startTime, ticksCPU);
-        isCPUIdle = false;
+  void execute(CPU& cpu) {
+    Process& execProc = cpu.execProc;
+    if (!cpu.isCPUIdle) {
+      execProc.exec();
+      if (execProc.state == Process::State::TERMINATED) {
+        LOG("\t", cpu.deviceName, execProc.procName << "[Comp]");
+        cpu.isCPUIdle = true;
+        totalProc--;
+        execProc.completionTime = ticksCPU;
+        completedProcs.push_back(execProc);
+        execProc = {};
+      } else if (execProc.state == Process::State::BLOCKED) {
+        LOG("\t", cpu.deviceName,
+            execProc.procName << "[Q IO]:" << execProc.burstRemainCPU);
+        execProc.saveContextOfq = (cpu.q + 1) % timeQuantum;
+        ioQ.push(execProc);
+        COUNT_PUSH(QUEUE_IO, ioQ.size());
+        cpu.isCPUIdle = true;
+        execProc = {};
+      } else {
+        LOG("\t", cpu.deviceName,
+            execProc.procName << ":" << execProc.burstRemainCPU)
       }
+    }
+  }
 
-      ioDevice();
-      ticksCPU++;
-      q++;
-      std::cout << "\n";
+  void schedule(CPU& cpu) {
+    Process& execProc = cpu.execProc;
+    bool toSchedule = (!readyQ.empty() || !auxQ.empty()) &&
+                      (cpu.isCPUIdle || cpu.q + 1 >= timeQuantum);
+    if (toSchedule) {
+      Process proc;
+      if (!auxQ.empty()) {
+        proc = auxQ.front();
+        auxQ.pop();
+        COUNT_POP(QUEUE_AUX);
+        cpu.q = proc.saveContextOfq - 1;
+      } else {
+        proc = readyQ.front();
+        readyQ.pop();
+        COUNT_POP(QUEUE_READY);
+        cpu.q = -1;
+      }
+      COUNT(contextSwitches);
+      if (!cpu.isCPUIdle) {
+        readyQ.push(execProc);
+        COUNT_PUSH(QUEUE_READY, readyQ.size());
+        COUNT(preemptions);
+      }
+      LOG("\t", cpu.deviceName, proc.procName << "[Sched]#q=" << cpu.q + 1)
+      execProc = proc;
+      execProc.startTime = std::min(execProc.startTime, ticksCPU);
+      cpu.isCPUIdle = false;
     }
   }
 
-  void ioDevice() {
-    if (!isIOIdle) {
-      if (++countIOBurst >= execProcIO.burstTimeIO) {
-        LOG("\t", "IO", execProcIO.procName << "[Comp]:" << countIOBurst)
+  void ioDevice(IO& io) {
+    Process& execProcIO = io.execProcIO;
+    if (!io.isIOIdle) {
+      if (++io.countIOBurst >= execProcIO.burstTimeIO) {
+        LOG("\t", io.deviceName,
+            execProcIO.procName << "[Comp]:" << io.countIOBurst)
         auxQ.push(execProcIO);
+        COUNT_PUSH(QUEUE_AUX, auxQ.size());
         execProcIO = {};
-        isIOIdle = true;
+        io.isIOIdle = true;
       } else {
-        LOG("\t", "IO", execProcIO.procName << ":" << countIOBurst)
+        LOG("\t", io.deviceName, execProcIO.procName << ":" << io.countIOBurst)
       }
     }
 
-    if (isIOIdle && !ioQ.empty()) {
+    if (io.isIOIdle && !ioQ.empty()) {
       execProcIO = ioQ.front();
       ioQ.pop();
-      countIOBurst = 0;
-      isIOIdle = false;
-      LOG("\t", "IO", execProcIO.procName << "[Sched]:" << countIOBurst)
+      COUNT_POP(QUEUE_IO);
+      io.countIOBurst = 0;
+      io.isIOIdle = false;
+      LOG("\t", io.deviceName,
+          execProcIO.procName << "[Sched]:" << io.countIOBurst)
     }
   }
 
-  void debug() {
+  void debug(Report& report) {
     for (auto& proc : completedProcs) {
-      LOG_DEBUG(proc.procName, "Arrival Time:\t", proc.arrivalTime)
-      LOG_DEBUG("", "Start Time:\t", proc.startTime)
-      LOG_DEBUG("", "Response Time:\t", proc.responseTime())
-      LOG_DEBUG("", "Completion Time:", proc.completionTime)
-      LOG_DEBUG("", "Turnaround Time:", proc.turnAroundTime())
-      LOG_DEBUG("", "Waiting Time:\t", proc.waitingTime() << "\n")
+      if (out && logProcs) {
+        LOG_DEBUG(proc.procName, "Arrival Time:\t", proc.arrivalTime)
+        LOG_DEBUG("", "Start Time:\t", proc.startTime)
+        LOG_DEBUG("", "Response Time:\t", proc.responseTime())
+        LOG_DEBUG("", "Completion Time:", proc.completionTime)
+        LOG_DEBUG("", "Turnaround Time:", proc.turnAroundTime())
+        LOG_DEBUG("", "Waiting Time:\t", proc.waitingTime() << "\n")
+      }
+      report.addProcess(proc.procName, proc.arrivalTime, proc.burstTimeCPU,
+                        proc.startTime, proc.completionTime,
+                        proc.waitingTime());
+    }
+    report.addMetric("avgWaitingTime", avgWaitingTime());
+    if (out) {
+      *out << "Avg Waiting Time: " << avgWaitingTime();
     }
-    std::cout << "Avg Waiting Time: " << avgWaitingTime();
   }
 
   double avgWaitingTime() {
@@ -177,23 +248,39 @@ class Device {
   size_t totalProc = 0;
   size_t ticksCPU = 0;
   size_t timeQuantum = 5;
-  bool isCPUIdle = true;
+  bool logProcs = true;
+  std::ostream* trace = nullptr;
+  std::ostream* out = nullptr;
 
-  size_t countIOBurst = 0;
-  bool isIOIdle = true;
-  Process execProcIO;
+  std::vector<CPU> cpus;
+  std::vector<IO> ios;
 
   std::queue<Process> readyQ;
   std::queue<Process> auxQ;
   std::queue<Process> ioQ;
 
+  bool waitingOnIO() {
+    if (!ioQ.empty()) {
+      return true;
+    }
+    for (auto& io : ios) {
+      if (!io.isIOIdle) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Processes arriving on the same tick join readyQ in trace order.
   void FreshArrivals() {
-    int index = 0;
-    for (auto& proc : procs) {
+    size_t index = 0;
+    while (index < procs.size()) {
+      Process& proc = procs[index];
       if (proc.arrivalTime == ticksCPU) {
         LOG("\t", "CPU", proc.procName << "[Arrive]")
         proc.state = Process::State::READY;
         readyQ.push(proc);
+        COUNT_PUSH(QUEUE_READY, readyQ.size());
         procs.erase(procs.begin() + index);
         continue;
       }
@@ -202,60 +289,37 @@ class Device {
   }
 };
 
-// Function to read processes from input file
-Processes readProcessesFromFile(const std::string& filename) {
+// Function to build processes from trace entries
+Processes toProcesses(TraceEntries& entries) {
   Processes processes;
-  std::ifstream inputFile(filename);
-  
-  if (!inputFile.is_open()) {
-    std::cerr << "Error: Unable to open file " << filename << std::endl;
-    return processes;
-  }
-  
-  std::string line;
-  while (std::getline(inputFile, line)) {
-    std::stringstream ss(line);
-    std::string procName;
-    size_t arrivalTime, burstTimeCPU, burstTimeIO, burstTimeRate;
-    
-    // Parse line with format: P0;0;24;2;5
-    std::getline(ss, procName, ';');
-    
-    std::string value;
-    std::getline(ss, value, ';');
-    arrivalTime = std::stoul(value);
-    
-    std::getline(ss, value, ';');
-    burstTimeCPU = std::stoul(value);
-    
-    std::getline(ss, value, ';');
-    burstTimeIO = std::stoul(value);
-    
-    std::getline(ss, value, ';');
-    burstTimeRate = std::stoul(value);
-    
-    // Create and add the process
-    processes.push_back(Process(std::move(procName), arrivalTime, burstTimeCPU, burstTimeIO, burstTimeRate));
+  for (auto& entry : entries) {
+    auto& f = entry.fields;
+    processes.push_back(
+        Process(std::move(entry.name), f[0], f[1], f[2], f[3]));
   }
-  
-  inputFile.close();
   return processes;
 }
 
-int main() {
+}  // namespace
+
+int vrr(const SchedOptions& opts, Report& report) {
   // Read processes from input file
-  Processes procs = readProcessesFromFile("input.txt");
-  
+  TraceEntries entries;
+  if (!readTrace(opts.trace, 4, SIZE_MAX, entries)) {
+    return 1;
+  }
+  Processes procs = toProcesses(entries);
+
   // Check if processes were successfully read
   if (procs.empty()) {
-    std::cerr << "No processes were read from the input file." << std::endl;
+    std::cerr << "No processes were read from " << opts.trace << std::endl;
     return 1;
   }
-  
+
   Device d;
-  d.init(procs);
+  d.init(procs, opts, report);
   d.processor();
-  d.debug();
+  d.debug(report);
 
   return 0;
-}
\ No newline at end of file
+}